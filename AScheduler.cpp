@@ -1,8 +1,15 @@
 #include "AScheduler.h"
 #include "ProcessScheduler.h"
+#include "CoreLoop.h"
+#include <algorithm>
+#include <climits>
 
 inline static std::atomic_int globalProcessCounter{ 1 };
 
+int Scheduler::nextPid() {
+    return globalProcessCounter.fetch_add(1);
+}
+
 std::string Scheduler::getTimestamp() {
 	char output[50];
 	std::time_t timestamp = std::time(nullptr);
@@ -19,38 +26,34 @@ std::string Scheduler::getTimestamp() {
 
 std::ostringstream Scheduler::displayScreenList() const {
     std::ostringstream out;
-    int activeCPUs = 0;
+    int activeCPUs = idleCores.busyCount();
 
-    // Prepare running process info
+    // Prepare running process info, for the busy cores only
     std::vector<std::string> runningInfo;
 
-    for (int i = 0; i < numCores; ++i) {
+    for (int i = idleCores.nextBusy(0); i >= 0; i = idleCores.nextBusy(i + 1)) {
         std::lock_guard<std::mutex> lock(coreMutexes[i]);
 
-        if (coreBusy[i] && coreBusy[i].get()->load()) {
-            activeCPUs++;
-
-            std::shared_ptr<Process> p = currentProcess[i];
-            if (p) {
-                std::time_t start_time_t = std::chrono::system_clock::to_time_t(p->getStartTime());
-                struct tm localTime;
-
-                std::ostringstream timeStream;
-                if (localtime_s(&localTime, &start_time_t) == 0) {
-                    timeStream << std::put_time(&localTime, "%m/%d/%Y %I:%M:%S %p");
-                }
-                else {
-                    timeStream << "[time error]";
-                }
-
-                std::ostringstream line;
-                line << std::left << std::setw(16) << p->getName()
-                    << std::setw(10) << ("Core " + std::to_string(i))
-                    << std::setw(14) << p->getCounter()
-                    << std::setw(12) << timeStream.str();
-
-                runningInfo.push_back(line.str());
+        Process* p = resolve(currentProcess[i]);
+        if (p) {
+            std::time_t start_time_t = std::chrono::system_clock::to_time_t(p->getStartTime());
+            struct tm localTime;
+
+            std::ostringstream timeStream;
+            if (localtime_s(&localTime, &start_time_t) == 0) {
+                timeStream << std::put_time(&localTime, "%m/%d/%Y %I:%M:%S %p");
+            }
+            else {
+                timeStream << "[time error]";
             }
+
+            std::ostringstream line;
+            line << std::left << std::setw(16) << p->getName()
+                << std::setw(10) << ("Core " + std::to_string(i))
+                << std::setw(14) << p->getCounter()
+                << std::setw(12) << timeStream.str();
+
+            runningInfo.push_back(line.str());
         }
     }
 
@@ -59,6 +62,10 @@ std::ostringstream Scheduler::displayScreenList() const {
     out << "CPU utilization: " << cpuUtil << "%" << std::endl;
     out << "Cores used: " << activeCPUs << std::endl;
     out << "Cores available: " << numCores - activeCPUs << std::endl;
+    if (realtimeAdmitted.load() > 0 || realtimeRejected.load() > 0) {
+        out << "Real-time processes: " << realtimeAdmitted.load() << " admitted, "
+            << realtimeRejected.load() << " rejected, " << deadlineMisses.load() << " deadline misses" << std::endl;
+    }
     out << std::endl;
 
     out << "--------------------------------" << std::endl;
@@ -79,9 +86,13 @@ std::ostringstream Scheduler::displayScreenList() const {
     out << "Finished processes:" << std::endl;
     {
         std::lock_guard<std::mutex> lock(finishedMutex);
-        for (const Process& p : finishedProcesses) {
-            out << std::left << std::setw(16) << p.getName()
-                << "Finished\t" << p.getCounter() << std::endl;
+        for (const FinishedProcess& p : finishedProcesses) {
+            out << std::left << std::setw(16) << p.name
+                << "Finished\t" << p.counter;
+            if (p.realtime) {
+                out << "\tdeadline " << (p.deadlineMissed ? "missed" : "met");
+            }
+            out << std::endl;
         }
     }
 
@@ -135,6 +146,7 @@ void Scheduler::schedulerStart() {
 				pid, processName, minIns, maxIns, requiredMem, numPages
             );
             p->setState(Process::State::READY);
+            p->setGroup("batch");	// kept apart from screen -s sessions for CPU quotas
 			//p->setNumPages(requiredMem / this->memPerFrame); 
 
             if (processList.size() <= static_cast<size_t>(pid))
@@ -186,22 +198,36 @@ void Scheduler::cleanUp() {
         cv.notify_all();
     }
 
-    // Clear the ready queue
+    // Clear the ready and suspended queues
     {
         std::lock_guard<std::mutex> lock(queueMutex);
         while (!readyQueue.empty()) {
             readyQueue.pop();
         }
+        realtimeQueue.clear();
+        suspendedQueue.clear();
+        throttledQueue.clear();
+        cloneHeld.clear();
+        realtimeDemand.clear();
     }
 
     // Clear current processes and mark all cores as not busy
     for (int i = 0; i < numCores; ++i) {
         if (i < static_cast<int>(currentProcess.size())) {
-            currentProcess[i] = nullptr;
+            currentProcess[i].reset();
         }
-        if (i < static_cast<int>(coreBusy.size()) && coreBusy[i]) {
-            coreBusy[i]->store(false);
+        if (i < idleCores.size()) {
+            idleCores.release(i);
+        }
+    }
+
+    // Let the core threads return before the static state they use is destroyed on exit
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (liveCoreThreads.load() > 0 && std::chrono::steady_clock::now() < deadline) {
+        for (auto& cv : cvCores) {
+            cv.notify_all();
         }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
     // Clear finished processes
@@ -210,6 +236,509 @@ void Scheduler::cleanUp() {
         finishedProcesses.clear();
     }
 
-    // Clear process list
+    // Clear process list. processTable is left alone: cores may still be
+    // mid-quantum on a process they borrowed from it.
     processList.clear();
+}
+
+ProcessHandle Scheduler::registerProcess(std::shared_ptr<Process> process) {
+    uint16_t group = cpuGroupIndex(process->getGroup());
+    std::lock_guard<std::mutex> lock(processTableMutex);
+    return processTable.insert(ProcessSlot(std::move(process), group));
+}
+
+void Scheduler::releaseProcess(ProcessHandle handle) {
+    std::lock_guard<std::mutex> lock(processTableMutex);
+    processTable.erase(handle);
+}
+
+Process* Scheduler::resolve(ProcessHandle handle) const {
+    const ProcessSlot* slot = processTable.get(handle);
+    return slot ? slot->process.get() : nullptr;
+}
+
+const ProcessSlot& Scheduler::slotOf(ProcessHandle handle) const {
+    return *processTable.get(handle);
+}
+
+const std::shared_ptr<Process>& Scheduler::owner(ProcessHandle handle) const {
+    return processTable.get(handle)->process;
+}
+
+void Scheduler::addProcess(std::shared_ptr<Process> process) {
+    if (!running.load()) {
+        return;
+    }
+
+    // Store process in processList for screen -ls functionality
+    if (processList.size() <= static_cast<size_t>(process->getPID()))
+        processList.resize(process->getPID() + 1);
+    processList[process->getPID()] = process;
+
+    // The process table owns the process while it is scheduled
+    ProcessHandle handle = registerProcess(process);
+    if (!handle.valid()) {
+        std::cerr << "[addProcess] Process table full, rejected " << process->getName() << "\n";
+        return;
+    }
+
+    // Try to allocate memory now; the scheduler retries on dispatch (clones arrive already allocated)
+    if (!process->isAllocated() && memoryAllocator.allocate(process)) {
+        process->setAllocation(true);
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    makeReady(handle);
+    cvScheduler.notify_one();
+}
+
+std::shared_ptr<Process> Scheduler::cloneProcess(const std::shared_ptr<Process>& source, const std::string& newName, CloneStatus& status) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    cloneSource = source.get();
+    auto deadline = std::chrono::steady_clock::now() + CLONE_WAIT;
+    while (source->getState() == Process::State::RUNNING && std::chrono::steady_clock::now() < deadline) {
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lock.lock();
+    }
+
+    std::shared_ptr<Process> child;
+    Process::State sourceState = source->getState();
+    status = sourceState == Process::State::RUNNING ? CloneStatus::ON_CORE : CloneStatus::NOT_RUNNING;
+    if (sourceState == Process::State::READY || sourceState == Process::State::SUSPENDED) {
+        child = source->clone(nextPid(), newName);
+        status = CloneStatus::CLONED;
+
+        // Resident pages are shared copy-on-write with the source under demand paging, and
+        // a copy that failed there would leave the child reading zero pages. The other
+        // allocators only give the child fresh memory, which its dispatch retries.
+        if (source->isAllocated()) {
+            if (memoryAllocator.cloneProcess(source, child)) {
+                child->setAllocation(true);
+            }
+            else if (demandPaging) {
+                status = CloneStatus::NO_MEMORY;
+            }
+        }
+
+        // The copy inherits the deadline, so it needs admission of its own
+        if (status == CloneStatus::CLONED && child->isRealtime()
+            && !admitRealtimeLocked(child->getPID(), static_cast<size_t>(child->getRemainingBurstTime()), child->getDeadline())) {
+            status = CloneStatus::NOT_ADMITTED;
+        }
+        if (status != CloneStatus::CLONED) {
+            if (child->isAllocated()) {
+                memoryAllocator.deallocate(child);
+            }
+            child.reset();
+        }
+    }
+
+    cloneSource = nullptr;
+    for (ProcessHandle handle : cloneHeld) {
+        if (resolve(handle)) {
+            makeReady(handle);
+        }
+    }
+    cloneHeld.clear();
+    cvScheduler.notify_one();
+    return child;
+}
+
+Process* Scheduler::takeForDispatch(ProcessHandle handle) {
+    Process* proc = resolve(handle);
+    if (!proc) {
+        return nullptr; // released while queued
+    }
+    if (parkThrottled(handle)) {
+        return nullptr; // group out of quota until the next period
+    }
+    if (proc == cloneSource) {
+        cloneHeld.push_back(handle);
+        return nullptr;
+    }
+    if (!proc->isAllocated()) {
+        if (!memoryAllocator.allocate(owner(handle))) {
+            makeReady(handle); // still no memory available, retry later
+            return nullptr;
+        }
+        proc->setAllocation(true);
+    }
+    return proc;
+}
+
+void Scheduler::assignCore(int core, ProcessHandle handle) {
+    resolve(handle)->setState(Process::State::RUNNING);
+    {
+        std::lock_guard<std::mutex> core_lock(coreMutexes[core]);
+        currentProcess[core] = handle;
+        idleCores.claim(core);
+    }
+    cvCores[core].notify_one(); // Notify the core thread to start processing
+}
+
+Process* Scheduler::waitForProcess(int coreID, std::unique_lock<std::mutex>& lock, ProcessHandle& handle) {
+    cvCores[coreID].wait(lock, [coreID]() {
+        return currentProcess[coreID].valid() || !running.load();
+        });
+
+    handle = currentProcess[coreID];
+    if (!handle.valid()) {
+        return nullptr;
+    }
+
+    // Borrowed from the process table, no reference count traffic per quantum
+    Process* proc = resolve(handle);
+    if (!proc) { // released while assigned
+        currentProcess[coreID].reset();
+        idleCores.release(coreID);
+        return nullptr;
+    }
+
+    if (proc->getStartTime() == std::chrono::system_clock::time_point{}) {
+        proc->setStartTime(std::chrono::system_clock::now());
+    }
+    return proc;
+}
+
+void Scheduler::retireProcess(ProcessHandle handle, int coreID) {
+    Process* proc = resolve(handle);
+    proc->setState(Process::State::TERMINATED);
+    proc->setEndTime(std::chrono::system_clock::now());
+
+    // Deallocate memory for the process
+    memoryAllocator.deallocate(owner(handle));
+    proc->setAllocation(false);
+
+    // Ensure process is properly tracked
+    if (processList.size() <= static_cast<size_t>(proc->getPID())) {
+        processList.resize(proc->getPID() + 1);
+    }
+    processList[proc->getPID()] = owner(handle);
+
+    { // safely add the process to the finished list
+        std::lock_guard<std::mutex> finished_lock(finishedMutex);
+        finishedProcesses.push_back({ proc->getName(), proc->getCounter(), proc->getArrivalTime(), proc->getEndTime(),
+            proc->isRealtime(), proc->hasMissedDeadline() });
+    }
+
+    // Freed under queueMutex so the scheduler cannot miss the wakeup
+    {
+        std::lock_guard<std::mutex> queue_lock(queueMutex);
+        updateRealtimeDemand(*proc);
+        releaseProcess(handle);
+        completedProcesses.fetch_add(1);
+        currentProcess[coreID].reset();
+        idleCores.release(coreID);
+    }
+    cvScheduler.notify_one();
+}
+
+void Scheduler::waitForReadyProcess(std::unique_lock<std::mutex>& lock) {
+    waitForWork(lock, []() { return false; });
+}
+
+bool Scheduler::hasIdleCore() const {
+    return idleCores.anyIdle();
+}
+
+void Scheduler::balanceMemoryLoad() {
+    if (memoryAllocator.isThrashing() && !readyQueue.empty()) {
+        // Suspend the lowest-priority ready process: the one with the most work left
+        std::vector<ProcessHandle> ready;
+        while (!readyQueue.empty()) {
+            if (resolve(readyQueue.front())) {
+                ready.push_back(readyQueue.front());
+            }
+            readyQueue.pop();
+        }
+        if (ready.empty()) {
+            return;
+        }
+
+        auto victim = std::max_element(ready.begin(), ready.end(),
+            [this](ProcessHandle a, ProcessHandle b) {
+                return resolve(a)->getRemainingBurstTime() < resolve(b)->getRemainingBurstTime();
+            });
+
+        ProcessHandle handle = *victim;
+        ready.erase(victim);
+        for (ProcessHandle h : ready) {
+            readyQueue.push(h);
+        }
+
+        suspendReadyProcess(handle);
+        return;
+    }
+
+    resumeSuspendedProcesses();
+}
+
+void Scheduler::suspendReadyProcess(ProcessHandle handle) {
+    Process* proc = resolve(handle);
+    if (proc->isAllocated()) {
+        memoryAllocator.suspendProcess(owner(handle));
+        proc->setState(Process::State::SUSPENDED);
+        suspendedQueue.push_back(handle);
+    }
+    else {
+        readyQueue.push(handle);
+    }
+}
+
+void Scheduler::resumeSuspendedProcesses() {
+    // Resume suspended processes in the order they were suspended while their working sets fit
+    while (!suspendedQueue.empty()) {
+        ProcessHandle handle = suspendedQueue.front();
+        Process* proc = resolve(handle);
+        if (!proc) {
+            suspendedQueue.pop_front();
+            continue;
+        }
+        if (!memoryAllocator.canResume(owner(handle))) {
+            break;
+        }
+        suspendedQueue.pop_front();
+        memoryAllocator.resumeProcess(owner(handle));
+        proc->setState(Process::State::READY);
+        makeReady(handle);
+    }
+}
+
+bool Scheduler::queueRealtime(ProcessHandle handle) {
+    const ProcessSlot& slot = slotOf(handle);
+    if (!slot.realtime) {
+        return false;
+    }
+    realtimeQueue.push(handle.index(), { slot.deadline, realtimeSequence++ }, handle);
+    return true;
+}
+
+bool Scheduler::popRealtime(ProcessHandle& handle) {
+    if (realtimeQueue.empty()) {
+        return false;
+    }
+    handle = realtimeQueue.pop().value;
+    return true;
+}
+
+void Scheduler::makeReady(ProcessHandle handle) {
+    if (!queueRealtime(handle)) {
+        readyQueue.push(handle);
+    }
+}
+
+uint16_t Scheduler::cpuGroupIndex(const std::string& name) {
+    const std::string& key = name.empty() ? "default" : name;
+    size_t count = cpuGroupCount.load();
+    for (size_t i = 0; i < count; ++i) {
+        if (cpuGroups[i].name == key) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cpuGroupMutex);
+    count = cpuGroupCount.load();
+    for (size_t i = 0; i < count; ++i) {
+        if (cpuGroups[i].name == key) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    if (count == 0) {
+        cpuGroups[count++].name = "default";
+        if (key == "default") {
+            cpuGroupCount.store(count);
+            return 0;
+        }
+    }
+    if (count == MAX_CPU_GROUPS) {
+        std::cerr << "[cpu groups] Limit of " << MAX_CPU_GROUPS << " groups reached, " << key << " joins default\n";
+        return 0;
+    }
+    cpuGroups[count].name = key;
+    cpuGroupCount.store(count + 1);
+    return static_cast<uint16_t>(count);
+}
+
+void Scheduler::setGroupQuota(const std::string& name, int64_t quota) {
+    CpuGroup& group = cpuGroups[cpuGroupIndex(name)];
+    group.quota.store(std::max<int64_t>(quota, 0));
+    group.runtime.store(group.quota.load());
+}
+
+int64_t Scheduler::takeRuntime(CpuGroup& group, int64_t wanted) {
+    // Granted up front so cores running the same group cannot overdraw it together
+    int64_t left = group.runtime.load();
+    int64_t granted;
+    do {
+        if (left <= 0) {
+            return 0;
+        }
+        granted = std::min(left, wanted);
+    } while (!group.runtime.compare_exchange_weak(left, left - granted));
+    return granted;
+}
+
+bool Scheduler::parkThrottled(ProcessHandle handle) {
+    const ProcessSlot& slot = slotOf(handle);
+    const CpuGroup& group = cpuGroups[slot.cpuGroup];
+    if (slot.realtime || group.quota.load() == 0 || group.runtime.load() > 0) {
+        return false;
+    }
+    throttledQueue.push_back(handle);
+    return true;
+}
+
+void Scheduler::refillCpuQuotas() {
+    uint64_t now = tickCount.load();
+    if (now < periodStart + static_cast<uint64_t>(cpuPeriod)) {
+        return;
+    }
+    periodStart = now;
+
+    size_t count = cpuGroupCount.load();
+    for (size_t i = 0; i < count; ++i) {
+        cpuGroups[i].runtime.store(cpuGroups[i].quota.load());
+        cpuGroups[i].throttled.store(false);
+    }
+    while (!throttledQueue.empty()) {
+        ProcessHandle handle = throttledQueue.front();
+        throttledQueue.pop_front();
+        if (resolve(handle)) {
+            makeReady(handle);
+        }
+    }
+}
+
+std::string Scheduler::cpuGroupStats() const {
+    size_t parked;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        parked = throttledQueue.size();
+    }
+
+    std::ostringstream out;
+    out << "CPU groups (period " << cpuPeriod << " ticks, " << parked << " processes throttled):" << std::endl;
+    size_t count = cpuGroupCount.load();
+    for (size_t i = 0; i < count; ++i) {
+        const CpuGroup& group = cpuGroups[i];
+        out << "  " << std::left << std::setw(12) << group.name << std::right
+            << " used " << std::setw(8) << group.used.load() << " ins  quota ";
+        if (group.quota.load() > 0) {
+            out << group.quota.load() << "/period (" << std::max<int64_t>(group.runtime.load(), 0) << " left)";
+        }
+        else {
+            out << "unlimited";
+        }
+        out << "  throttled " << group.throttles.load() << " periods" << std::endl;
+    }
+    return out.str();
+}
+
+bool Scheduler::admitRealtime(int pid, size_t instructions, uint64_t deadlineTick) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return admitRealtimeLocked(pid, instructions, deadlineTick);
+}
+
+bool Scheduler::admitRealtimeLocked(int pid, size_t instructions, uint64_t deadlineTick) {
+    uint64_t now = tickCount.load();
+    if (deadlineTick <= now) {
+        realtimeRejected++;
+        return false;
+    }
+
+    // Remaining demand of every admitted real-time process still due, plus the new one
+    std::vector<std::pair<uint64_t, size_t>> demands{ { deadlineTick, instructions } };
+    for (const auto& [admitted, demand] : realtimeDemand) {
+        if (admitted != pid && demand.first > now) {
+            demands.push_back(demand);
+        }
+    }
+    std::sort(demands.begin(), demands.end());
+
+    // EDF is feasible when, for every deadline, the work due by then fits in the
+    // cores' capacity until then, and each process fits on the single core it runs on
+    uint64_t perCore = static_cast<uint64_t>(std::max(realtimeRate, 1));
+    uint64_t due = 0;
+    for (const auto& [deadline, work] : demands) {
+        due += work;
+        uint64_t ticks = deadline - now;
+        if (work > perCore * ticks || due > perCore * ticks * numCores) {
+            realtimeRejected++;
+            return false;
+        }
+    }
+    realtimeDemand[pid] = { deadlineTick, instructions };
+    realtimeAdmitted++;
+    return true;
+}
+
+void Scheduler::updateRealtimeDemand(const Process& proc) {
+    auto it = realtimeDemand.find(proc.getPID());
+    if (it == realtimeDemand.end()) {
+        return;
+    }
+    if (proc.isFinished()) {
+        realtimeDemand.erase(it);
+    }
+    else {
+        it->second.second = static_cast<size_t>(proc.getRemainingBurstTime());
+    }
+}
+
+int Scheduler::runOnCore(ProcessHandle handle, int coreID, int maxInstructions) {
+	const ProcessSlot& slot = slotOf(handle);
+	Process& proc = *slot.process;
+
+	// A throttled group gets no instructions; the process is parked at its next dispatch
+	CpuGroup* group = slot.realtime ? nullptr : &cpuGroups[slot.cpuGroup];
+	int64_t granted = 0;
+	if (group && group->quota.load() > 0) {
+		granted = takeRuntime(*group, maxInstructions < 0 ? INT64_MAX : maxInstructions);
+		if (granted == 0) {
+			return 0;
+		}
+		maxInstructions = static_cast<int>(std::min<int64_t>(granted, INT_MAX));
+	}
+
+	int executed;
+	if (demandPaging) {
+		executed = executeInstructions(*demandPaging, accessModel, proc, coreID, maxInstructions, delayPerExec, running);
+	}
+	else {
+		executed = executeInstructions(memoryAllocator, accessModel, proc, coreID, maxInstructions, delayPerExec, running);
+	}
+
+	if (group) {
+		group->used += executed;
+		if (granted > 0 && group->runtime.fetch_add(granted - executed) + (granted - executed) <= 0
+			&& !group->throttled.exchange(true)) {
+			group->throttles++;
+		}
+	}
+
+	// Counted once, as soon as the core notices the deadline has passed
+	if (slot.realtime && tickCount.load() > slot.deadline && !proc.hasMissedDeadline()) {
+		proc.markDeadlineMissed();
+		deadlineMisses++;
+	}
+	return executed;
+}
+
+double Scheduler::getMeanTurnaroundMs(size_t& finished) const {
+    std::lock_guard<std::mutex> lock(finishedMutex);
+    finished = finishedProcesses.size();
+    if (finished == 0) {
+        return 0.0;
+    }
+    std::chrono::duration<double, std::milli> total{ 0 };
+    for (const FinishedProcess& p : finishedProcesses) {
+        total += p.endTime - p.arrivalTime;
+    }
+    return total.count() / finished;
+}
+
+size_t Scheduler::getSuspendedCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return suspendedQueue.size();
 }
\ No newline at end of file
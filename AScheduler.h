@@ -5,6 +5,10 @@
 #include <sstream>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <map>
+#include <array>
+#include <algorithm>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
@@ -16,8 +20,25 @@
 
 #include "Process.h"
 #include "MemoryAllocator.h"
+#include "PageAccessModel.h"
+#include "SlotMap.h"
+#include "ProcessSlot.h"
+#include "IndexedMinHeap.h"
+#include "IdleCoreMask.h"
 
-// abstract class for schedulers: FCFS, RR
+typedef SlotHandle ProcessHandle;
+
+// A named group of processes sharing one CPU quota (see Scheduler::cpuGroups)
+struct CpuGroup {
+	std::string name;                   // written once, before cpuGroupCount counts it
+	std::atomic_int64_t quota{ 0 };     // instructions per period, 0 for unlimited
+	std::atomic_int64_t runtime{ 0 };   // quota left this period
+	std::atomic_uint64_t used{ 0 };     // instructions executed, over all periods
+	std::atomic_uint64_t throttles{ 0 }; // periods in which the quota ran out
+	std::atomic_bool throttled{ false };
+};
+
+// abstract class for schedulers: FCFS, RR, SJF/SRTF, MLFQ, CFS, lottery, stride
 class Scheduler {
 protected:
 
@@ -32,45 +53,163 @@ protected:
 	size_t memPerFrame = 4096;
 	size_t minMemPerProc = 1024; 
 	size_t maxMemPerProc = 8192; 
+	PageAccessModel accessModel;	// pages touched per executed instruction
+	int realtimeRate = 5;		// instructions a core is assumed to run per CPU tick, for admission
 
 	inline static std::atomic_uint64_t tickCount{ 0 };         // CPU tick counter
 	inline static std::atomic_bool tickThreadRunning{ false };  // Only one tick thread
-	inline static std::queue<std::shared_ptr<Process>> readyQueue;
+	// Processes owned by the scheduler live in processTable; queues and cores pass
+	// 32-bit handles around instead of copying shared_ptrs on every dispatch, and
+	// dispatch decisions read the attributes kept in the slot
+	// (never destroyed: detached core threads can still look handles up while the program exits)
+	inline static SlotMap<ProcessSlot>& processTable = *new SlotMap<ProcessSlot>();
+	inline static std::mutex processTableMutex;	// serializes insert/erase, lookups take no lock
+	ProcessHandle registerProcess(std::shared_ptr<Process> process);
+	void releaseProcess(ProcessHandle handle);
+	Process* resolve(ProcessHandle handle) const;	// null once the process has been released
+	const ProcessSlot& slotOf(ProcessHandle handle) const;	// handle must resolve
+	const std::shared_ptr<Process>& owner(ProcessHandle handle) const;	// handle must resolve
+
+	inline static std::queue<ProcessHandle> readyQueue;
 	inline static std::mutex queueMutex;
 	inline static std::condition_variable cvScheduler;
 
 	inline static std::vector<std::condition_variable> cvCores;
 	inline static std::vector<std::mutex> coreMutexes;
-	inline static std::vector<std::shared_ptr<Process>> currentProcess; // current process running on each core
-	inline static std::vector<std::unique_ptr<std::atomic_bool>> coreBusy;; // flags to check if a core is busy
+	inline static std::vector<ProcessHandle> currentProcess; // current process running on each core
+	inline static IdleCoreMask idleCores;	// bit set while a core has no process; cores release, the scheduler claims
 
 	inline static std::atomic_bool running{ true };
+	inline static std::atomic_int liveCoreThreads{ 0 };	// cleanUp waits for these to return
 	inline static std::atomic_int completedProcesses{ 0 }; // count of completed processes
 
+	// What screen -ls and the turnaround report keep of a finished process: a summary,
+	// not a copy of the Process, so neither its commands nor its arena are held here
+	struct FinishedProcess {
+		std::string name;
+		std::string counter;
+		Process::TimePoint arrivalTime;
+		Process::TimePoint endTime;
+		bool realtime = false;
+		bool deadlineMissed = false;
+	};
 	inline static std::mutex finishedMutex;
-	inline static std::vector<Process> finishedProcesses;
+	inline static std::vector<FinishedProcess> finishedProcesses;
+
+	// Real-time class: processes with a deadline, dispatched earliest deadline first
+	// ahead of whatever order the scheduler keeps. Guarded by queueMutex.
+	inline static IndexedMinHeap<std::pair<uint64_t, uint64_t>, ProcessHandle> realtimeQueue;	// (deadline, arrival)
+	inline static uint64_t realtimeSequence = 0;
+	inline static std::atomic_int realtimeAdmitted{ 0 };
+	inline static std::atomic_int realtimeRejected{ 0 };
+	// Admitted real-time processes that have not finished, by PID: (deadline, instructions
+	// left when last off a core). Admission sums this, guarded by queueMutex.
+	inline static std::map<int, std::pair<uint64_t, size_t>> realtimeDemand;
+	bool admitRealtimeLocked(int pid, size_t instructions, uint64_t deadlineTick);	// caller must hold queueMutex
+	void updateRealtimeDemand(const Process& proc);	// off a core, caller must hold queueMutex
+	inline static std::atomic_int deadlineMisses{ 0 };
+	bool queueRealtime(ProcessHandle handle);	// false, queueing nothing, for a normal process
+	bool popRealtime(ProcessHandle& handle);
+	void makeReady(ProcessHandle handle);	// real-time queue or readyQueue, caller must hold queueMutex
+
+	// Process groups with a CPU quota per period, like cgroup CPU bandwidth control.
+	// Cores charge every instruction to the process's group; once a group has used
+	// its quota it is throttled, and its processes are parked in throttledQueue at
+	// dispatch until the next period refills the quota. Real-time processes are exempt.
+	static constexpr size_t MAX_CPU_GROUPS = 64;
+	inline static std::array<CpuGroup, MAX_CPU_GROUPS> cpuGroups;	// [0] is the default group
+	inline static std::atomic_size_t cpuGroupCount{ 0 };
+	inline static std::mutex cpuGroupMutex;	// serializes adding groups, lookups take no lock
+	inline static int cpuPeriod = 1;			// CPU ticks
+	inline static uint64_t periodStart = 0;		// guarded by queueMutex
+	inline static std::deque<ProcessHandle> throttledQueue;	// guarded by queueMutex
+	static uint16_t cpuGroupIndex(const std::string& name);	// adds the group on first use
+	static int64_t takeRuntime(CpuGroup& group, int64_t wanted);
+	bool parkThrottled(ProcessHandle handle);	// caller must hold queueMutex
+	void refillCpuQuotas();	// at a period boundary, caller must hold queueMutex
+
+	// Medium-term scheduling: processes swapped out while memory is thrashing
+	inline static std::deque<ProcessHandle> suspendedQueue;
+	void balanceMemoryLoad(); // caller must hold queueMutex
+	void suspendReadyProcess(ProcessHandle handle);	// one taken off the ready queue, caller must hold queueMutex
+	void resumeSuspendedProcesses();	// onto the ready queue, caller must hold queueMutex
+	bool hasIdleCore() const;
+
+	// Waits on queueMutex for arrivals, or for an idle core while a real-time process
+	// or one the policy keeps queued (queued()) is waiting; periodic wakes it regardless
+	template <typename Queued>
+	void waitForWork(std::unique_lock<std::mutex>& lock, Queued queued, bool periodic = false) {
+		auto ready = [this, &queued]() {
+			return !readyQueue.empty() || ((queued() || !realtimeQueue.empty()) && hasIdleCore()) || !running.load();
+		};
+		if (suspendedQueue.empty() && throttledQueue.empty() && !periodic) {
+			cvScheduler.wait(lock, ready);
+		}
+		else {
+			// Wake up periodically so suspended processes can be resumed once memory frees up,
+			// and throttled ones released when the period ends
+			cvScheduler.wait_for(lock, std::chrono::milliseconds(50), ready);
+		}
+		refillCpuQuotas();
+	}
+	void waitForReadyProcess(std::unique_lock<std::mutex>& lock);	// everything queued is in readyQueue
+
+	// Process being cloned, kept off the cores until the copy is taken; dispatches of it
+	// wait in cloneHeld. Guarded by queueMutex.
+	inline static const Process* cloneSource = nullptr;
+	inline static std::vector<ProcessHandle> cloneHeld;
+
+	// Dispatch, caller must hold queueMutex. takeForDispatch vets a handle taken off a
+	// queue: null when the process is gone, parked for its group's quota, or still
+	// without memory (then back on the ready queue). assignCore hands it to an idle core
+	// and marks it RUNNING, so under queueMutex READY and SUSPENDED mean off-core.
+	Process* takeForDispatch(ProcessHandle handle);
+	void assignCore(int core, ProcessHandle handle);
+
+	// Core side. waitForProcess waits on the core's lock for an assignment and borrows the
+	// process from the process table; null when there is none or it was released meanwhile.
+	// After the quantum, with the core's lock held again, retireProcess finishes a completed
+	// process, and requeueProcess hands an unfinished one to requeue under queueMutex.
+	// Both free the core.
+	Process* waitForProcess(int coreID, std::unique_lock<std::mutex>& lock, ProcessHandle& handle);
+	void retireProcess(ProcessHandle handle, int coreID);
+	template <typename Requeue>
+	void requeueProcess(Process& proc, int coreID, Requeue requeue) {
+		{
+			std::lock_guard<std::mutex> queue_lock(queueMutex);
+			proc.setState(Process::State::READY);
+			updateRealtimeDemand(proc);
+			requeue();
+			currentProcess[coreID].reset();
+			idleCores.release(coreID);
+		}
+		cvScheduler.notify_one();
+	}
 
 	std::string getTimestamp();
 
 	// MCO2
 	IMemoryAllocator& memoryAllocator;
+	DemandPagingAllocator* demandPaging;	// resolved once, null for the other allocators
+
+	// Runs a process on a core through the loop instantiated for the allocator in use
+	int runOnCore(ProcessHandle handle, int coreID, int maxInstructions);
 
 public:
-	Scheduler(int cores, IMemoryAllocator& allocator) : numCores(cores), memoryAllocator(allocator) {
+	Scheduler(int cores, IMemoryAllocator& allocator)
+		: numCores(cores), memoryAllocator(allocator), demandPaging(dynamic_cast<DemandPagingAllocator*>(&allocator)) {
 		// initialize vectors based on the number of cores
 		cvCores = std::vector<std::condition_variable>(numCores);
 		coreMutexes = std::vector<std::mutex>(numCores);
-		currentProcess.resize(numCores, nullptr);
-		coreBusy.resize(numCores);
-		for (int i = 0; i < numCores; ++i) {
-			coreBusy[i] = std::make_unique<std::atomic_bool>(false);
-		}
+		currentProcess.resize(numCores);
+		idleCores.reset(numCores);
 	}
 	~Scheduler() = default;
 
-	virtual void addProcess(std::shared_ptr<Process> process) = 0;
+	virtual void addProcess(std::shared_ptr<Process> process);	// into the process table and readyQueue
 	virtual void schedulerThread() = 0; // 1 thread
 	virtual void cpuCoreThread(int coreID) = 0; // {numCores} threads
+	virtual std::string schedulerStats() const { return std::string(); } // policy-specific lines for vmstat
 
 	// String stream for screen -ls
 	std::ostringstream displayScreenList() const;
@@ -89,10 +228,38 @@ public:
 	void setMemPerFrame(size_t m) { memPerFrame = m; }
 	void setMinMemPerProc(size_t m) { minMemPerProc = m; }
 	void setMaxMemPerProc(size_t m) { maxMemPerProc = m; }
+	void setAccessModel(const PageAccessModel& m) { accessModel = m; }
 
 	std::vector<std::shared_ptr<Process>> processList;
 
 	uint64_t getTickCount() const { return tickCount.load(); }
-	const std::vector<std::unique_ptr<std::atomic_bool>>& getCoreBusy() const { return coreBusy; }
+	static int nextPid();	// shared by batch, screen and cloned processes
+
+	// Fork-like copy of source and its memory, taken under queueMutex while no core is
+	// running it. Source is held back from dispatch meanwhile, and waited for up to
+	// CLONE_WAIT if a core has it. Null unless status is CLONED.
+	enum class CloneStatus {
+		CLONED,
+		NOT_RUNNING,    // source finished or was never scheduled
+		ON_CORE,        // still running after CLONE_WAIT
+		NOT_ADMITTED,   // the copy of a real-time process would miss its deadline
+		NO_MEMORY       // the source's pages could not be copied
+	};
+	static constexpr std::chrono::milliseconds CLONE_WAIT{ 2000 };
+	std::shared_ptr<Process> cloneProcess(const std::shared_ptr<Process>& source, const std::string& newName, CloneStatus& status);
+	size_t getSuspendedCount() const;
+	double getMeanTurnaroundMs(size_t& finished) const;	// arrival to completion
+
+	// EDF admission: whether process pid, with the given instruction count, can finish by
+	// deadlineTick alongside the real-time processes already admitted; it counts as
+	// admitted from then until it finishes
+	bool admitRealtime(int pid, size_t instructions, uint64_t deadlineTick);
+	void setRealtimeRate(int r) { realtimeRate = r; }
+
+	void setCpuPeriod(int ticks) { cpuPeriod = std::max(ticks, 1); }
+	void setGroupQuota(const std::string& name, int64_t quota);
+	std::string cpuGroupStats() const;	// usage and throttling per group, for vmstat
+
+	const IdleCoreMask& getIdleCores() const { return idleCores; }
 };
 
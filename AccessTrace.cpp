@@ -0,0 +1,117 @@
+#include "AccessTrace.h"
+#include <cstring>
+#include <iterator>
+
+namespace {
+    constexpr char MAGIC[8] = { 'C', 'S', 'T', 'R', 'A', 'C', 'E', '1' };
+    constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    bool getVarint(const std::vector<uint8_t>& data, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+            uint8_t byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+AccessTraceWriter::AccessTraceWriter(const std::string& fileName, size_t frameSize)
+    : file(fileName, std::ios::out | std::ios::binary | std::ios::trunc) {
+    buffer.reserve(FLUSH_BYTES + 32);
+    if (file.is_open()) {
+        file.write(MAGIC, sizeof(MAGIC));
+        putVarint(frameSize);
+    }
+}
+
+AccessTraceWriter::~AccessTraceWriter() {
+    flush();
+}
+
+void AccessTraceWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void AccessTraceWriter::record(size_t processId, size_t pageNumber, bool isWrite) {
+    uint32_t pid = static_cast<uint32_t>(processId);
+    uint32_t page = static_cast<uint32_t>(pageNumber);
+    bool pidChanged = pid != lastProcess;
+
+    uint32_t& previous = lastPage[pid];
+    int64_t delta = static_cast<int64_t>(page) - static_cast<int64_t>(previous);
+    previous = page;
+    lastProcess = pid;
+
+    putVarint(zigzag(delta) << 2 | uint64_t{ isWrite } << 1 | uint64_t{ pidChanged });
+    if (pidChanged) {
+        putVarint(pid);
+    }
+
+    records++;
+    if (buffer.size() >= FLUSH_BYTES) {
+        flush();
+    }
+}
+
+void AccessTraceWriter::flush() {
+    if (file.is_open() && !buffer.empty()) {
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        file.flush();
+    }
+    buffer.clear();
+}
+
+bool readAccessTrace(const std::string& fileName, std::vector<PageAccess>& accesses, size_t& frameSize) {
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(MAGIC) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    size_t pos = sizeof(MAGIC);
+    uint64_t value;
+    if (!getVarint(data, pos, value)) {
+        return false;
+    }
+    frameSize = static_cast<size_t>(value);
+
+    std::unordered_map<uint32_t, uint32_t> lastPage;
+    uint32_t pid = UINT32_MAX;
+    accesses.clear();
+    accesses.reserve(data.size() - pos);
+
+    while (pos < data.size()) {
+        uint64_t token;
+        if (!getVarint(data, pos, token)) {
+            return false;
+        }
+        if (token & 1) {
+            if (!getVarint(data, pos, value)) {
+                return false;
+            }
+            pid = static_cast<uint32_t>(value);
+        }
+
+        uint32_t& previous = lastPage[pid];
+        previous = static_cast<uint32_t>(static_cast<int64_t>(previous) + unzigzag(token >> 2));
+        accesses.push_back(PageAccess{ pid, previous, (token & 2) != 0 });
+    }
+    return true;
+}
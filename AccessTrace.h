@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Compact binary trace of page accesses.
+// File layout: "CSTRACE1", varint frame size, then one record per access:
+//   varint(zigzag(page - previous page of the same pid) << 2 | write << 1 | pidChanged)
+//   [varint(pid) when pidChanged]
+// Accesses with good locality take a single byte.
+struct PageAccess {
+    uint32_t processId;
+    uint32_t pageNumber;
+    bool isWrite;
+};
+
+class AccessTraceWriter {
+public:
+    AccessTraceWriter(const std::string& fileName, size_t frameSize);
+    ~AccessTraceWriter();
+
+    bool isOpen() const { return file.is_open(); }
+    void record(size_t processId, size_t pageNumber, bool isWrite);
+    void flush();
+    size_t getRecords() const { return records; }
+
+private:
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+    std::unordered_map<uint32_t, uint32_t> lastPage;
+    uint32_t lastProcess = UINT32_MAX;
+    size_t records = 0;
+
+    void putVarint(uint64_t value);
+};
+
+// Reads a whole trace; returns false if the file is missing or malformed
+bool readAccessTrace(const std::string& fileName, std::vector<PageAccess>& accesses, size_t& frameSize);
@@ -0,0 +1,234 @@
+#include "BackingStore.h"
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+BackingStore::BackingStore(const std::string& fileName, size_t slotSize)
+    : fileName(fileName), slotSize(std::max(slotSize, size_t{ 1 })) {
+    // Contents from a previous run are meaningless, so always start from an empty file
+#ifdef _WIN32
+    HANDLE h = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h != INVALID_HANDLE_VALUE) {
+        DWORD returned = 0;
+        DeviceIoControl(h, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr); // enables hole punching
+        handle = h;
+    }
+#else
+    fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+
+    if (!isOpen()) {
+        std::cerr << "[BackingStore] ERROR: Could not open backing store file: " << fileName << std::endl;
+    }
+}
+
+BackingStore::~BackingStore() {
+#ifdef _WIN32
+    if (handle) CloseHandle(static_cast<HANDLE>(handle));
+#else
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+bool BackingStore::isOpen() const {
+#ifdef _WIN32
+    return handle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+size_t BackingStore::allocateSlot() {
+    // Lowest free slot first keeps the swap file compact and I/O mostly sequential
+    size_t word = searchHint;
+    while (word < usedBitmap.size() && usedBitmap[word] == ~uint64_t{ 0 }) {
+        word++;
+    }
+    if (word == usedBitmap.size()) {
+        usedBitmap.push_back(0);
+        freedBitmap.push_back(0);
+    }
+    searchHint = word;
+
+    size_t slot = word * 64 + std::countr_one(usedBitmap[word]);
+    claimSlot(slot);
+    return slot;
+}
+
+size_t BackingStore::allocateSlot(size_t preferred) {
+    if (preferred / 64 > usedBitmap.size() || isSlotUsed(preferred)) {
+        return allocateSlot();
+    }
+    while (preferred / 64 >= usedBitmap.size()) {
+        usedBitmap.push_back(0);
+        freedBitmap.push_back(0);
+    }
+    claimSlot(preferred);
+    return preferred;
+}
+
+bool BackingStore::isSlotUsed(size_t slot) const {
+    return slot / 64 < usedBitmap.size() && (usedBitmap[slot / 64] & (uint64_t{ 1 } << (slot % 64)));
+}
+
+void BackingStore::claimSlot(size_t slot) {
+    size_t word = slot / 64;
+    uint64_t mask = uint64_t{ 1 } << (slot % 64);
+    usedBitmap[word] |= mask;
+    if (freedBitmap[word] & mask) {
+        freedBitmap[word] &= ~mask;
+        pendingFrees--;
+    }
+    usedSlots++;
+
+    ensureCapacity(slot);
+}
+
+void BackingStore::freeSlot(size_t slot) {
+    size_t word = slot / 64;
+    uint64_t mask = uint64_t{ 1 } << (slot % 64);
+    if (word >= usedBitmap.size() || !(usedBitmap[word] & mask)) {
+        return;
+    }
+
+    usedBitmap[word] &= ~mask;
+    freedBitmap[word] |= mask;
+    usedSlots--;
+    pendingFrees++;
+    searchHint = std::min(searchHint, word);
+}
+
+bool BackingStore::writeSlot(size_t slot, const char* data) {
+    uint64_t offset = static_cast<uint64_t>(slot) * slotSize;
+#ifdef _WIN32
+    OVERLAPPED ov{};
+    ov.Offset = static_cast<DWORD>(offset);
+    ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD written = 0;
+    return WriteFile(static_cast<HANDLE>(handle), data, static_cast<DWORD>(slotSize), &written, &ov) && written == slotSize;
+#else
+    return ::pwrite(fd, data, slotSize, static_cast<off_t>(offset)) == static_cast<ssize_t>(slotSize);
+#endif
+}
+
+bool BackingStore::readSlots(size_t firstSlot, size_t count, char* data) {
+    uint64_t offset = static_cast<uint64_t>(firstSlot) * slotSize;
+    size_t length = count * slotSize;
+#ifdef _WIN32
+    OVERLAPPED ov{};
+    ov.Offset = static_cast<DWORD>(offset);
+    ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD read = 0;
+    return ReadFile(static_cast<HANDLE>(handle), data, static_cast<DWORD>(length), &read, &ov) && read == length;
+#else
+    return ::pread(fd, data, length, static_cast<off_t>(offset)) == static_cast<ssize_t>(length);
+#endif
+}
+
+void BackingStore::ensureCapacity(size_t slot) {
+    if (slot < fileSlots) {
+        return;
+    }
+    // Grow in whole extents so the file system can lay the swap file out contiguously
+    size_t slots = (slot / EXTENT_SLOTS + 1) * EXTENT_SLOTS;
+    if (resizeFile(slots)) {
+#if !defined(_WIN32) && defined(__linux__)
+        ::fallocate(fd, 0, static_cast<off_t>(fileSlots * slotSize), static_cast<off_t>((slots - fileSlots) * slotSize));
+#endif
+        fileSlots = slots;
+    }
+}
+
+size_t BackingStore::highestUsedSlot() const {
+    for (size_t word = usedBitmap.size(); word-- > 0;) {
+        if (usedBitmap[word] != 0) {
+            return word * 64 + std::bit_width(usedBitmap[word]);
+        }
+    }
+    return 0;
+}
+
+bool BackingStore::resizeFile(size_t slots) {
+    uint64_t size = static_cast<uint64_t>(slots) * slotSize;
+#ifdef _WIN32
+    LARGE_INTEGER li;
+    li.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE h = static_cast<HANDLE>(handle);
+    return SetFilePointerEx(h, li, nullptr, FILE_BEGIN) && SetEndOfFile(h);
+#else
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+void BackingStore::punchHole(size_t firstSlot, size_t count) {
+    uint64_t offset = static_cast<uint64_t>(firstSlot) * slotSize;
+    uint64_t length = static_cast<uint64_t>(count) * slotSize;
+#ifdef _WIN32
+    FILE_ZERO_DATA_INFORMATION zero;
+    zero.FileOffset.QuadPart = static_cast<LONGLONG>(offset);
+    zero.BeyondFinalZero.QuadPart = static_cast<LONGLONG>(offset + length);
+    DWORD returned = 0;
+    if (!DeviceIoControl(static_cast<HANDLE>(handle), FSCTL_SET_ZERO_DATA, &zero, sizeof(zero), nullptr, 0, &returned, nullptr)) {
+        return;
+    }
+#elif defined(__linux__)
+    if (::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(length)) != 0) {
+        return;
+    }
+#else
+    return; // no portable hole punching; truncation still reclaims the tail
+#endif
+    bytesPunched += length;
+}
+
+void BackingStore::trim() {
+    if (!isOpen()) {
+        return;
+    }
+
+    // Truncate everything past the last used slot, rounded up to a whole extent
+    size_t keepSlots = (highestUsedSlot() + EXTENT_SLOTS - 1) / EXTENT_SLOTS * EXTENT_SLOTS;
+    if (keepSlots < fileSlots && resizeFile(keepSlots)) {
+        fileSlots = keepSlots;
+    }
+
+    // Punch holes for long runs freed since the last trim inside the kept part
+    size_t minRun = std::max(size_t{ 1 }, PUNCH_MIN_BYTES / slotSize);
+    size_t runStart = 0;
+    size_t runLength = 0;
+    for (size_t slot = 0; slot <= fileSlots; ++slot) {
+        bool freed = slot < fileSlots && slot / 64 < freedBitmap.size()
+            && (freedBitmap[slot / 64] & (uint64_t{ 1 } << (slot % 64)));
+        if (freed) {
+            if (runLength == 0) runStart = slot;
+            runLength++;
+        }
+        else {
+            if (runLength >= minRun) {
+                punchHole(runStart, runLength);
+            }
+            runLength = 0;
+        }
+    }
+
+    std::fill(freedBitmap.begin(), freedBitmap.end(), 0);
+    pendingFrees = 0;
+
+    // Drop bitmap words past the end of the file
+    size_t words = (fileSlots + 63) / 64;
+    if (usedBitmap.size() > words) {
+        usedBitmap.resize(words);
+        freedBitmap.resize(words);
+    }
+    searchHint = std::min(searchHint, usedBitmap.size());
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Swap file used by the demand paging allocator.
+// Slots are handed out from a bitmap, lowest free slot first, so swap I/O
+// stays near the start of the file. The file grows in preallocated extents;
+// freed runs are punched out and the unused tail is truncated by trim().
+class BackingStore {
+public:
+    static constexpr size_t EXTENT_SLOTS = 256;     // file grows and shrinks in multiples of this
+    static constexpr size_t PUNCH_MIN_BYTES = 64 * 1024;
+
+    BackingStore(const std::string& fileName, size_t slotSize);
+    ~BackingStore();
+
+    BackingStore(const BackingStore&) = delete;
+    BackingStore& operator=(const BackingStore&) = delete;
+
+    bool isOpen() const;
+
+    size_t allocateSlot();
+    size_t allocateSlot(size_t preferred);  // preferred slot if free, else the lowest free one
+    bool isSlotUsed(size_t slot) const;
+    void freeSlot(size_t slot);
+    bool writeSlot(size_t slot, const char* data);
+    bool readSlot(size_t slot, char* data) { return readSlots(slot, 1, data); }
+    bool readSlots(size_t firstSlot, size_t count, char* data); // one read for adjacent slots
+
+    // Punch holes for freed runs and truncate the unused tail of the file
+    void trim();
+    bool shouldTrim() const { return pendingFrees >= EXTENT_SLOTS || (usedSlots == 0 && fileSlots > 0); }
+
+    size_t getUsedSlots() const { return usedSlots; }
+    size_t getFileSize() const { return fileSlots * slotSize; }
+    size_t getBytesPunched() const { return bytesPunched; }
+
+private:
+    std::string fileName;
+    size_t slotSize;
+
+    std::vector<uint64_t> usedBitmap;       // bit set = slot holds a page
+    std::vector<uint64_t> freedBitmap;      // bit set = freed since the last trim
+    size_t searchHint = 0;                  // lowest word that may have a free slot
+    size_t usedSlots = 0;
+    size_t pendingFrees = 0;
+    size_t fileSlots = 0;                   // slots covered by the file's current size
+    size_t bytesPunched = 0;
+
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    void ensureCapacity(size_t slot);       // preallocate the extent holding slot
+    void claimSlot(size_t slot);
+    size_t highestUsedSlot() const;         // 0 when empty, otherwise last used slot + 1
+    bool resizeFile(size_t slots);
+    void punchHole(size_t firstSlot, size_t count);
+};
@@ -0,0 +1,287 @@
+#include "Benchmark.h"
+#include "CoreLoop.h"
+#include "SlotMap.h"
+#include "ProcessSlot.h"
+#include "IdleCoreMask.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int INSTRUCTIONS_PER_PROCESS = 1000;
+
+    // The core loop before specialization: allocator type checked on every instruction
+    int legacyLoop(IMemoryAllocator& allocator, const PageAccessModel& accessModel, Process& proc, int coreID) {
+        int executed = 0;
+        while (!proc.isFinished()) {
+            DemandPagingAllocator* demandPagingAlloc = dynamic_cast<DemandPagingAllocator*>(&allocator);
+            if (demandPagingAlloc && proc.getNumPages() > 0) {
+                bool isWrite;
+                size_t page = accessModel.nextPage(proc.getAccessCursor(), proc.getNumPages(), isWrite);
+                demandPagingAlloc->accessPage(proc.getPID(), page, isWrite);
+            }
+            proc.executeCurrentCommand(coreID);
+            proc.moveToNextLine();
+            executed++;
+        }
+        return executed;
+    }
+
+    // The real commands sleep in ICommand::execute, which would hide the loop itself
+    class NopCommand : public ICommand {
+    public:
+        explicit NopCommand(int pid) : ICommand(pid, DECLARE) {}
+        String getOutput() const override { return String(); }
+        std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<NopCommand>(newPid, newTable, resource); }
+        void execute() override {}
+    };
+
+    Process::CommandList makeProgram(int pid) {
+        Process::CommandList program(INSTRUCTIONS_PER_PROCESS);
+        for (auto& command : program) {
+            command = std::make_shared<NopCommand>(pid);
+        }
+        return program;
+    }
+
+    // Nanoseconds per instruction over fresh processes of INSTRUCTIONS_PER_PROCESS each
+    template <typename Run>
+    double timeLoop(IMemoryAllocator& allocator, size_t instructions, Run run) {
+        std::chrono::nanoseconds elapsed{ 0 };
+        size_t executed = 0;
+        for (int pid = 1; executed < instructions; ++pid) {
+            auto proc = std::make_shared<Process>(pid, "bench", 0, 0, 0, 0);
+            proc->setCustomInstructions(makeProgram(pid));
+            allocator.allocate(proc);
+
+            auto start = std::chrono::steady_clock::now();
+            executed += run(*proc);
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            allocator.deallocate(proc);
+        }
+        return static_cast<double>(elapsed.count()) / executed;
+    }
+
+    int benchCoreLoop(size_t instructions) {
+        const char* storeFile = "bench_backing_store.dat";
+        PageAccessModel accessModel;
+        std::atomic_bool keepRunning{ true };
+        auto demandPaging = std::make_unique<DemandPagingAllocator>(1 << 20, 256, 4096, storeFile);
+        FlatMemoryAllocator flat(1 << 20, 256);
+
+        std::cout << "Core loop, " << instructions << " instructions per run (ns/instruction)" << std::endl;
+        std::cout << std::left << std::setw(16) << "Allocator" << std::setw(12) << "Legacy"
+            << std::setw(12) << "Specialized" << std::endl;
+
+        auto report = [&](const std::string& name, IMemoryAllocator& base, auto& derived) {
+            double legacy = timeLoop(base, instructions, [&](Process& proc) {
+                return legacyLoop(base, accessModel, proc, 0);
+                });
+            double specialized = timeLoop(base, instructions, [&](Process& proc) {
+                return executeInstructions(derived, accessModel, proc, 0, -1, 0, keepRunning);
+                });
+            std::cout << std::setw(16) << name << std::fixed << std::setprecision(1)
+                << std::setw(12) << legacy << std::setw(12) << specialized << std::endl;
+        };
+        report("demand-paging", *demandPaging, *demandPaging);
+        IMemoryAllocator& flatBase = flat;
+        report("flat", flat, flatBase);
+
+        demandPaging.reset();   // close the swap file before removing it
+        std::remove(storeFile);
+        return 0;
+    }
+
+    // Resident memory of this program in bytes, 0 if unavailable
+    size_t residentBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.WorkingSetSize;
+        }
+        return 0;
+#else
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0, residentPages = 0;
+        if (statm >> totalPages >> residentPages) {
+            return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+        return 0;
+#endif
+    }
+
+    // Memory per queued process, and the cost of a scheduler-style pass over the
+    // process table against one that also reads the Process and its cold state
+    int benchFootprint(size_t count) {
+        SlotMap<ProcessSlot> table;
+        std::vector<SlotHandle> handles;
+        handles.reserve(count);
+
+        size_t before = residentBytes();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            int pid = static_cast<int>(i) + 1;
+            auto proc = std::make_shared<Process>(pid, "p" + std::to_string(pid), 0, 0, 0, 1);
+            proc->setState(Process::State::READY);
+            SlotHandle handle = table.insert(ProcessSlot(std::move(proc), 0));
+            if (!handle.valid()) {
+                std::cerr << "Process table full after " << i << " processes" << std::endl;
+                return 1;
+            }
+            handles.push_back(handle);
+        }
+        double createSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t after = residentBytes();
+
+        // Dispatch decisions: the attributes kept in the table's slots
+        start = std::chrono::steady_clock::now();
+        uint64_t tickets = 0;
+        for (SlotHandle handle : handles) {
+            const ProcessSlot& slot = *table.get(handle);
+            tickets += slot.realtime ? 0 : slot.tickets + slot.cpuGroup;
+        }
+        double slotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // What a core reads of the Process itself
+        start = std::chrono::steady_clock::now();
+        size_t ready = 0;
+        for (SlotHandle handle : handles) {
+            const Process& proc = *table.get(handle)->process;
+            ready += proc.getState() == Process::State::READY && proc.getRemainingBurstTime() >= 0;
+        }
+        double hotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Same pass reading a cold field as well
+        start = std::chrono::steady_clock::now();
+        size_t nameBytes = 0;
+        for (SlotHandle handle : handles) {
+            nameBytes += table.get(handle)->process->getName().size();
+        }
+        double coldSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Processes created: " << count << " in " << std::fixed << std::setprecision(2) << createSeconds << " s" << std::endl;
+        std::cout << "Table slot (sizeof ProcessSlot): " << sizeof(ProcessSlot) << " bytes" << std::endl;
+        std::cout << "Hot state (sizeof Process): " << sizeof(Process) << " bytes" << std::endl;
+        if (before > 0 && after > before) {
+            std::cout << "Resident memory per process: " << (after - before) / count << " bytes" << std::endl;
+        }
+        std::cout << "Slot scan: " << std::setprecision(1) << slotSeconds * 1e9 / count << " ns/process (" << tickets << " tickets)" << std::endl;
+        std::cout << "Hot scan: " << hotSeconds * 1e9 / count << " ns/process (" << ready << " ready)" << std::endl;
+        std::cout << "Hot + cold scan: " << coldSeconds * 1e9 / count << " ns/process (" << nameBytes << " name bytes)" << std::endl;
+        return 0;
+    }
+
+    // One core frees up and the dispatcher finds and claims it, with every other core
+    // busy: the steady state of a loaded emulator. Compared with the per-core flags the
+    // schedulers used to scan, and the utilization read vmstat and screen -ls make.
+    int benchDispatch(size_t iterations) {
+        std::cout << "Dispatch, " << iterations << " claims per run (ns/claim, ns/utilization read)" << std::endl;
+        std::cout << std::left << std::setw(8) << "Cores" << std::setw(12) << "Flag scan" << std::setw(12) << "Idle mask"
+            << std::setw(12) << "Flag count" << std::setw(12) << "Mask count" << std::endl;
+
+        for (int cores : { 8, 64, 256 }) {
+            std::vector<int> freed(4096);
+            std::mt19937 random(cores);
+            for (int& core : freed) {
+                core = static_cast<int>(random() % cores);
+            }
+            size_t sink = 0;
+            auto nsPer = [iterations](std::chrono::steady_clock::time_point start) {
+                return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+            };
+
+            std::vector<std::unique_ptr<std::atomic_bool>> busy(cores);
+            for (auto& flag : busy) {
+                flag = std::make_unique<std::atomic_bool>(true);
+            }
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                busy[freed[i % freed.size()]]->store(false);
+                for (int core = 0; core < cores; ++core) {
+                    if (!busy[core]->load()) {
+                        busy[core]->store(true);
+                        sink += core;
+                        break;
+                    }
+                }
+            }
+            double scanClaim = nsPer(start);
+
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                int active = 0;
+                for (int core = 0; core < cores; ++core) {
+                    active += busy[core]->load();
+                }
+                sink += active;
+            }
+            double scanCount = nsPer(start);
+
+            IdleCoreMask mask;
+            mask.reset(cores);
+            for (int core = 0; core < cores; ++core) {
+                mask.claim(core);
+            }
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                mask.release(freed[i % freed.size()]);
+                int core = mask.nextIdle(0);
+                if (core >= 0 && mask.claim(core)) {
+                    sink += core;
+                }
+            }
+            double maskClaim = nsPer(start);
+
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                sink += mask.busyCount();
+            }
+            double maskCount = nsPer(start);
+
+            std::cout << std::setw(8) << cores << std::fixed << std::setprecision(1)
+                << std::setw(12) << scanClaim << std::setw(12) << maskClaim
+                << std::setw(12) << scanCount << std::setw(12) << maskCount
+                << (sink == 0 ? " " : "") << std::endl;   // keeps the loops from being optimized out
+        }
+        return 0;
+    }
+}
+
+int Benchmark::runFromCommandLine(int argc, char* argv[]) {
+    std::string name = argc > 2 ? argv[2] : "";
+    size_t count = 0;
+    if (argc > 3) {
+        try {
+            count = std::stoull(argv[3]);
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid count: " << argv[3] << std::endl;
+            return 1;
+        }
+    }
+
+    if (name == "core") {
+        return benchCoreLoop(count > 0 ? count : 1000000);
+    }
+    if (name == "footprint") {
+        return benchFootprint(count > 0 ? count : 1000000);
+    }
+    if (name == "dispatch") {
+        return benchDispatch(count > 0 ? count : 1000000);
+    }
+
+    std::cerr << "Usage: " << argv[0] << " --bench <core [instructions] | footprint [processes] | dispatch [claims]>" << std::endl;
+    return 1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Micro-benchmarks run from the command line instead of the emulator:
+//   --bench core [instructions]   per-instruction cost of the core execution loop
+//   --bench footprint [processes] memory per queued process, hot vs cold scan cost
+//   --bench dispatch [claims]     finding and claiming an idle core at 8, 64 and 256 cores
+namespace Benchmark {
+    int runFromCommandLine(int argc, char* argv[]);
+}
@@ -0,0 +1,177 @@
+#include "CFSScheduler.h"
+#include <algorithm>
+
+// Same table as Linux: each nice level is ~10% CPU relative to the next
+static const uint64_t NICE_WEIGHTS[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15,
+};
+
+uint64_t CFSScheduler::weightOf(int nice) {
+    return NICE_WEIGHTS[std::clamp(nice, -20, 19) + 20];
+}
+
+CFSScheduler::Entity& CFSScheduler::entityOf(ProcessHandle handle) {
+    bool fresh;
+    Entity& entity = entities.get(handle, fresh);
+    if (fresh) {
+        // New processes start level with the least-served runnable one
+        entity.vruntime = minVruntime;
+        entity.weight = weightOf(resolve(handle) ? slotOf(handle).nice : 0);
+    }
+    return entity;
+}
+
+void CFSScheduler::enqueue(Entity& entity) {
+    if (!entity.runnable) {
+        entity.runnable = true;
+        entity.vruntime = std::max(entity.vruntime, minVruntime);
+        runnableWeight += entity.weight;
+        runnableCount++;
+    }
+    timeline.insert({ entity.vruntime, entity.handle.value });
+    peakSpread = std::max(peakSpread, timeline.rbegin()->first - timeline.begin()->first);
+}
+
+void CFSScheduler::leaveRunnable(Entity& entity) {
+    if (entity.runnable) {
+        entity.runnable = false;
+        runnableWeight -= entity.weight;
+        runnableCount--;
+    }
+}
+
+void CFSScheduler::collectArrivals() {
+    while (!readyQueue.empty()) {
+        ProcessHandle handle = readyQueue.front();
+        readyQueue.pop();
+        if (resolve(handle)) {
+            enqueue(entityOf(handle));
+        }
+    }
+}
+
+void CFSScheduler::balanceTimeline() {
+    if (memoryAllocator.isThrashing() && !timeline.empty()) {
+        // Suspend the rightmost process, the one that has had the most CPU
+        auto victim = std::prev(timeline.end());
+        ProcessHandle handle;
+        handle.value = victim->second;
+        timeline.erase(victim);
+        if (resolve(handle)) {
+            leaveRunnable(entityOf(handle));
+            suspendReadyProcess(handle);
+        }
+        return;
+    }
+
+    resumeSuspendedProcesses();
+}
+
+int CFSScheduler::sliceFor(const Entity& entity) const {
+    uint64_t total = std::max(runnableWeight, entity.weight);
+    int slice = static_cast<int>(static_cast<uint64_t>(targetLatency) * entity.weight / total);
+    return std::max({ slice, minGranularity, 1 });
+}
+
+void CFSScheduler::account(Entity& entity, int executed) {
+    entity.vruntime += static_cast<uint64_t>(executed) * NICE_0_WEIGHT * VRUNTIME_SCALE / entity.weight;
+    uint64_t leftmost = timeline.empty() ? entity.vruntime : std::min(entity.vruntime, timeline.begin()->first);
+    minVruntime = std::max(minVruntime, leftmost);
+}
+
+void CFSScheduler::schedulerThread() {
+    while (running.load() || !readyQueue.empty()) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        // Wake up for arrivals, and for freed cores while processes are runnable
+        waitForWork(lock, [this]() { return !timeline.empty(); });
+
+        collectArrivals();
+        balanceTimeline();
+        collectArrivals();  // resumed processes
+
+        // Give each idle core the earliest deadline, or else the least virtual runtime
+        for (int core = idleCores.nextIdle(0); core >= 0 && (!timeline.empty() || !realtimeQueue.empty()); core = idleCores.nextIdle(core + 1)) {
+            ProcessHandle handle;
+            if (!popRealtime(handle)) {
+                handle.value = timeline.begin()->second;
+                timeline.erase(timeline.begin());
+            }
+
+            if (takeForDispatch(handle)) {
+                // Real-time processes get the whole target latency
+                coreSlice[core] = slotOf(handle).realtime ? std::max(targetLatency, 1) : sliceFor(entityOf(handle));
+                assignCore(core, handle);
+            }
+        }
+    }
+}
+
+void CFSScheduler::cpuCoreThread(int coreID) {
+    liveCoreThreads.fetch_add(1);
+    while (running.load() || currentProcess[coreID].valid()) {
+        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
+
+        ProcessHandle handle;
+        Process* proc = waitForProcess(coreID, lock, handle);
+        if (!proc) continue;
+        int slice = coreSlice[coreID];
+
+        lock.unlock();
+
+        int executed = runOnCore(handle, coreID, slice);
+        if (!running.load()) break; // exiting, cleanUp has emptied the queues
+
+        lock.lock();
+        if (proc->isFinished()) {
+            if (!slotOf(handle).realtime) {
+                std::lock_guard<std::mutex> queue_lock(queueMutex);
+                Entity& entity = entityOf(handle);
+                account(entity, executed);
+                leaveRunnable(entity);
+            }
+            retireProcess(handle, coreID);
+        }
+        else {
+            // Slice used up: back into the tree at its new virtual runtime
+            requeueProcess(*proc, coreID, [&]() {
+                if (!queueRealtime(handle)) {
+                    Entity& entity = entityOf(handle);
+                    account(entity, executed);
+                    enqueue(entity);
+                }
+                });
+        }
+    }
+    liveCoreThreads.fetch_sub(1);
+}
+
+std::string CFSScheduler::schedulerStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    // Spread over every runnable process, queued or running
+    uint64_t lowest = UINT64_MAX;
+    uint64_t highest = 0;
+    for (const Entity& entity : entities) {
+        if (entity.runnable) {
+            lowest = std::min(lowest, entity.vruntime);
+            highest = std::max(highest, entity.vruntime);
+        }
+    }
+    uint64_t spread = runnableCount > 0 ? highest - lowest : 0;
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "CFS runnable processes: " << runnableCount << " (total weight " << runnableWeight << ")" << std::endl;
+    out << "CFS min vruntime: " << static_cast<double>(minVruntime) / VRUNTIME_SCALE << std::endl;
+    out << "CFS vruntime spread: " << static_cast<double>(spread) / VRUNTIME_SCALE << " now, "
+        << static_cast<double>(peakSpread) / VRUNTIME_SCALE << " peak (instructions at nice 0)" << std::endl;
+    return out.str();
+}
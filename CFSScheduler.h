@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+#include "AScheduler.h"
+
+// Completely fair scheduler. Runnable processes are ordered by virtual runtime,
+// the instructions they have executed scaled by their nice weight, in a balanced
+// tree; each dispatch takes the leftmost one. A timeslice is the process's share
+// of targetLatency by weight, so it shrinks as more processes become runnable,
+// but never below minGranularity instructions.
+class CFSScheduler : public Scheduler {
+public:
+    static constexpr uint64_t NICE_0_WEIGHT = 1024;
+
+    CFSScheduler(int cores, int targetLatency, int minGranularity, IMemoryAllocator& allocator)
+        : Scheduler(cores, allocator), targetLatency(targetLatency), minGranularity(minGranularity),
+        coreSlice(cores, 0) {
+    }
+
+    void schedulerThread() override;
+    void cpuCoreThread(int coreID) override;
+    std::string schedulerStats() const override;
+
+    static uint64_t weightOf(int nice);
+
+private:
+    // Virtual runtime is kept in 1/1024ths of an instruction at nice 0
+    static constexpr uint64_t VRUNTIME_SCALE = 1024;
+
+    struct Entity {
+        ProcessHandle handle;
+        uint64_t vruntime = 0;
+        uint64_t weight = NICE_0_WEIGHT;
+        bool runnable = false;      // queued or running, counted in runnableWeight
+    };
+
+    int targetLatency;
+    int minGranularity;
+
+    // Guarded by queueMutex; readyQueue takes arrivals and resumed processes
+    std::set<std::pair<uint64_t, uint32_t>> timeline;  // (vruntime, handle value)
+    SlotTable<Entity> entities;
+    std::vector<int> coreSlice;                         // slice of the process dispatched to each core
+    uint64_t minVruntime = 0;                           // never decreases
+    uint64_t runnableWeight = 0;
+    size_t runnableCount = 0;
+    uint64_t peakSpread = 0;
+
+    Entity& entityOf(ProcessHandle handle);
+    void enqueue(Entity& entity);
+    void leaveRunnable(Entity& entity);
+    void collectArrivals();
+    void balanceTimeline();
+    int sliceFor(const Entity& entity) const;
+    void account(Entity& entity, int executed);
+};
@@ -5,6 +5,8 @@
 #include <chrono>
 #include <thread>
 #include <vector>
+#include <memory>
+#include <memory_resource>
 
 #include "SymbolTable.h"
 
@@ -31,11 +33,22 @@ public:
 	CommandType getCommandType();
 	virtual String getOutput() const = 0;
 	virtual void execute();
+	// Copy bound to another process and symbol table, used when a process is cloned;
+	// allocated from that process's arena
+	virtual std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const = 0;
 
 protected:
 	int pid;
 	CommandType cmdType;
 	TablePtr table; // Optional, can be nullptr if not needed
+
+	template <typename T>
+	std::shared_ptr<ICommand> cloneAs(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const {
+		auto copy = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), static_cast<const T&>(*this));
+		copy->pid = newPid;
+		copy->table = newTable;
+		return copy;
+	}
 	
 };
 
@@ -43,6 +56,7 @@ class PrintCommand : public ICommand {
 public:
 	PrintCommand(int pid, TablePtr table, std::vector<String> printTokens);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<PrintCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void parsePrintTokens();
 
@@ -56,6 +70,7 @@ class DeclareCommand : public ICommand {
 public:
 	DeclareCommand(int pid, TablePtr table, String varName, uint16_t value);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<DeclareCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void performDeclaration();
 
@@ -69,6 +84,7 @@ class AddCommand : public ICommand {
 public:
 	AddCommand(int pid, TablePtr table, String out, String var1, String var2);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<AddCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void performAddition();
 
@@ -84,6 +100,7 @@ class SubtractCommand : public ICommand {
 public:
 	SubtractCommand(int pid, TablePtr table, String out, String var1, String var2);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<SubtractCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void performSubtraction();
 
@@ -99,6 +116,7 @@ class ReadCommand : public ICommand {
 public:
 	ReadCommand(int pid, TablePtr table, String outVar, uintptr_t address);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<ReadCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void performRead();
 private:
@@ -112,6 +130,7 @@ public:
 	WriteCommand(int pid, TablePtr table, uintptr_t address, uint16_t value);
 	WriteCommand(int pid, TablePtr table, uintptr_t address, String varName);
 	String getOutput() const override { return output; }
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<WriteCommand>(newPid, newTable, resource); }
 	void execute() override;
 	void performWrite();
 private:
@@ -125,6 +144,7 @@ class SleepCommand : public ICommand {
 public:
 	SleepCommand(int pid, int duration);
 	String getOutput() const override;
+	std::shared_ptr<ICommand> clone(int newPid, TablePtr newTable, std::pmr::memory_resource* resource) const override { return cloneAs<SleepCommand>(newPid, newTable, resource); }
 	void execute() override;
 
 private:
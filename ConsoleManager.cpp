@@ -46,7 +46,7 @@ void ConsoleManager::openScreen(const std::string& name) {
 	}
 }
 
-void ConsoleManager::startScreen(const std::string& name, size_t memorySize) {
+void ConsoleManager::startScreen(const std::string& name, size_t memorySize, const ScreenOptions& options) {
     // Check if the screen name exists in our consoles map
     auto it = consoles.find(name);
     
@@ -54,12 +54,36 @@ void ConsoleManager::startScreen(const std::string& name, size_t memorySize) {
         std::cerr << "Process '" << name << "' already exists. Use resume to continue." << std::endl;
         return;
     }
-    // Screen doesn't exist, start a new one
-    auto newProcessConsole = std::make_shared<ProcessConsole>(name, memorySize);
+    // Screen doesn't exist, start a new one. A real-time process is admitted on the
+    // instructions it was given before it is scheduled
+    std::shared_ptr<Process> process = ProcessScheduler::getInstance().createProcess(name, memorySize);
+    if (options.deadlineTicks > 0 && !ProcessScheduler::getInstance().admitDeadline(process, options.deadlineTicks)) {
+        std::cout << "Deadline of " << options.deadlineTicks << " ticks cannot be guaranteed alongside the admitted real-time processes; "
+            << "process not admitted." << std::endl;
+        return;
+    }
+    auto newProcessConsole = std::make_shared<ProcessConsole>(process, options);
     consoles[name] = newProcessConsole;
     currentConsole = newProcessConsole;
 }
 
+void ConsoleManager::cloneScreen(const std::string& sourceName, const std::string& name) {
+    if (consoles.find(sourceName) == consoles.end()) {
+        std::cerr << "Process '" << sourceName << "' does not exist." << std::endl;
+        return;
+    }
+    if (consoles.find(name) != consoles.end() || ProcessScheduler::getInstance().processExists(name)) {
+        std::cerr << "Process '" << name << "' already exists." << std::endl;
+        return;
+    }
+
+    // The clone runs in the background; attach with screen -r
+    if (ProcessScheduler::getInstance().cloneProcess(sourceName, name)) {
+        consoles[name] = std::make_shared<ProcessConsole>(name);
+        std::cout << "Cloned '" << sourceName << "' as '" << name << "'." << std::endl;
+    }
+}
+
 void ConsoleManager::customScreen(const std::string& name, const std::vector<std::vector<std::string>> commands) {
     // Check if the screen name exists in our consoles map
     auto it = consoles.find(name);
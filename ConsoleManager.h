@@ -16,7 +16,8 @@ public:
     void init();  // Initialize main console
     void showMainConsole();  // Return to main menu
     void openScreen(const std::string& name);  // resume process screen
-    void startScreen(const std::string& name, size_t memorySize);
+    void startScreen(const std::string& name, size_t memorySize, const ScreenOptions& options = ScreenOptions());
+    void cloneScreen(const std::string& sourceName, const std::string& name); // Fork an existing screen -s process
     void customScreen(const std::string& name, const std::vector<std::vector<std::string>> commands); // Open custom process with command
     void openMarquee(); // startup the marquee console
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <type_traits>
+#include "Process.h"
+#include "MemoryAllocator.h"
+#include "PageAccessModel.h"
+
+// Executes up to maxInstructions of a process (to completion when negative) on one core,
+// stopping early once running is cleared.
+// Instantiated per allocator type: only the demand paging build touches pages, and it
+// calls the allocator directly instead of casting it on every instruction.
+template <typename Allocator>
+int executeInstructions(Allocator& allocator, const PageAccessModel& accessModel, Process& proc,
+    int coreID, int maxInstructions, int delayPerExec, const std::atomic_bool& running) {
+    int executed = 0;
+    while ((maxInstructions < 0 || executed < maxInstructions) && !proc.isFinished() && running.load()) {
+        if constexpr (std::is_same_v<Allocator, DemandPagingAllocator>) {
+            if (proc.getNumPages() > 0) {
+                bool isWrite;
+                size_t page = accessModel.nextPage(proc.getAccessCursor(), proc.getNumPages(), isWrite);
+                allocator.accessPage(proc.getPID(), page, isWrite);
+            }
+        }
+
+        proc.executeCurrentCommand(coreID);
+        proc.moveToNextLine();
+        executed++;
+
+        if (delayPerExec > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayPerExec));
+        }
+    }
+    return executed;
+}
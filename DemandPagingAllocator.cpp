@@ -1,41 +1,21 @@
 #include "MemoryAllocator.h"
 #include <chrono>
 #include <random>
+#include <iomanip>
+#include <cstring>
 
 DemandPagingAllocator::DemandPagingAllocator(size_t maxMemorySize, size_t frameSize, size_t maxFrames, const std::string& backingStoreFile)
-    : maxMemorySize(maxMemorySize), frameSize(frameSize), maxFrames(maxFrames), backingStoreFile(backingStoreFile), nextBackingStoreOffset(0) {
+    : maxMemorySize(maxMemorySize), frameSize(frameSize), maxFrames(maxFrames), backingStoreFile(backingStoreFile),
+      backingStore(backingStoreFile, frameSize) {
 
     // Initialize physical memory frames
     frames.resize(maxFrames);
     for (size_t i = 0; i < maxFrames; ++i) {
         freeFrames.push(i);
     }
-
-    // Initialize backing store
-    initializeBackingStore();
-
-}
-
-DemandPagingAllocator::~DemandPagingAllocator() {
-    if (backingStore.is_open()) {
-        backingStore.close();
-    }
 }
 
-void DemandPagingAllocator::initializeBackingStore() {
-    // Create or open backing store file
-    backingStore.open(backingStoreFile, std::ios::in | std::ios::out | std::ios::binary);
-    if (!backingStore.is_open()) {
-        // Create new file
-        backingStore.open(backingStoreFile, std::ios::out | std::ios::binary);
-        backingStore.close();
-        backingStore.open(backingStoreFile, std::ios::in | std::ios::out | std::ios::binary);
-    }
-
-    if (!backingStore.is_open()) {
-        std::cerr << "[DemandPaging] ERROR: Could not open backing store file: " << backingStoreFile << std::endl;
-    }
-}
+DemandPagingAllocator::~DemandPagingAllocator() = default;
 
 void* DemandPagingAllocator::allocate(std::shared_ptr<Process> process) {
     std::lock_guard<std::mutex> lock(allocatorMutex);
@@ -44,7 +24,14 @@ void* DemandPagingAllocator::allocate(std::shared_ptr<Process> process) {
     size_t numPages = process->getNumPages();
 
     // Create page table for the process (initially all pages not present)
-    processPageTables[processId].resize(numPages);
+    if (pageDirectory.size() <= processId) {
+        pageDirectory.resize(processId + 1);
+        processStats.resize(processId + 1);
+        accounting.resize(processId + 1);
+    }
+    pageDirectory[processId] = PageTable(numPages);
+    processStats[processId] = ProcessPagingStats{};
+    accounting[processId] = ProcessMemoryAccounting{};
 
     // In demand paging, we don't allocate physical frames immediately
     // Pages will be allocated when first accessed (page fault)
@@ -57,36 +44,50 @@ void DemandPagingAllocator::deallocate(std::shared_ptr<Process> process) {
 
     size_t processId = process->getPID();
 
-    auto pageTableIt = processPageTables.find(processId);
-    if (pageTableIt == processPageTables.end()) {
+    if (processId >= pageDirectory.size()) {
         return; // Process not found
     }
+    releasePages(processId);
+}
 
-    std::vector<PageTableEntry>& pageTable = pageTableIt->second;
+void DemandPagingAllocator::releasePages(size_t processId) {
+    PageTable& pageTable = pageDirectory[processId];
     size_t deallocatedFrames = 0;
 
     // Free all physical frames and backing store slots used by this process
-    for (size_t pageNum = 0; pageNum < pageTable.size(); ++pageNum) {
-        PageTableEntry& entry = pageTable[pageNum];
-
-        if (entry.present) {
+    pageTable.forEach([&](size_t pageNumber, PageTableEntry& entry) {
+        if (entry.isPresent() && sharedMappers.count(entry.getFrameNumber())) {
+            // Other processes still map this frame
+            detachMapping(entry.getFrameNumber(), processId, pageNumber);
+        }
+        else if (entry.isPresent()) {
             // Free physical frame
-            size_t frameNum = entry.frameNumber;
-            frames[frameNum].occupied = false;
-            frames[frameNum].processId = 0;
-            frames[frameNum].pageNumber = 0;
+            size_t frameNum = entry.getFrameNumber();
+            frames.release(frameNum);
             freeFrames.push(frameNum);
             deallocatedFrames++;
             usedFrames--;
         }
-        else if (entry.backingStoreOffset > 0) {
+        else if (entry.isCompressed()) {
+            swapCache.erase(CompressedSwapCache::makeKey(processId, pageNumber));
+        }
+        else if (entry.isSwapped()) {
             // Free backing store slot
-            deallocateBackingStoreSlot(entry.backingStoreOffset);
+            backingStore.freeSlot(entry.getSwapSlot());
+            backingStoreSize--;
         }
+    });
+
+    // Give freed swap space back to the file system once enough has piled up
+    if (backingStore.shouldTrim()) {
+        backingStore.trim();
     }
 
-    // Remove process page table
-    processPageTables.erase(pageTableIt);
+    // Remove process page table; fault and I/O totals stay for process-smi
+    pageTable = PageTable();
+    processStats[processId] = ProcessPagingStats{};
+    accounting[processId].residentPages = 0;
+    accounting[processId].swappedPages = 0;
 
     // Update statistics
     numPagedOut += deallocatedFrames;
@@ -95,42 +96,78 @@ void DemandPagingAllocator::deallocate(std::shared_ptr<Process> process) {
 bool DemandPagingAllocator::accessPage(size_t processId, size_t pageNumber, bool isWrite) {
     std::lock_guard<std::mutex> lock(allocatorMutex);
 
-    auto pageTableIt = processPageTables.find(processId);
-    if (pageTableIt == processPageTables.end() || pageNumber >= pageTableIt->second.size()) {
+    if (processId >= pageDirectory.size()) {
+        return false;
+    }
+
+    if (trace) {
+        trace->record(processId, pageNumber, isWrite);
+    }
+
+    // Touching the page allocates its page table levels on first use
+    PageTableEntry* entryPtr = pageDirectory[processId].touch(pageNumber);
+    if (!entryPtr) {
        return false;
     }
 
-    PageTableEntry& entry = pageTableIt->second[pageNumber];
+    PageTableEntry& entry = *entryPtr;
+    ProcessPagingStats& stats = processStats[processId];
+
+    if (windowAccesses >= workingSetWindow) {
+        closeWorkingSetWindow();
+    }
+    windowAccesses++;
+    stats.windowAccesses++;
 
     // Check if page is present in physical memory
-    if (entry.present) {
+    if (entry.isPresent() && isWrite && entry.isCopyOnWrite()) {
+        return breakCopyOnWrite(processId, pageNumber, entry);
+    }
+    if (entry.isPresent()) {
         // Page hit - update access information
-        entry.referenced = true;
+        if (entry.bits & PageTableEntry::READAHEAD) {
+            numReadaheadHits++;
+            recentReadaheadHits++;
+            entry.setFlag(PageTableEntry::READAHEAD, false);
+        }
+        entry.setFlag(PageTableEntry::REFERENCED, true);
         if (isWrite) {
-            entry.dirty = true;
+            entry.setFlag(PageTableEntry::DIRTY, true);
+        }
+        frames.lastAccessed[entry.getFrameNumber()] = ++accessClock;
+        return true;
+    }
+
+    // Reads of a page with no contents map the shared zero page instead of a frame
+    if (!isWrite && (entry.isZero() || entry.bits == 0)) {
+        if (!entry.isZero()) {
+            entry.bits = PageTableEntry::ZERO;
+            numZeroPageMaps++;
+            accounting[processId].minorFaults++;
         }
-        frames[entry.frameNumber].lastAccessed = std::chrono::steady_clock::now();
         return true;
     }
 
     // Page fault occurred
     numPageFaults++;
+    windowFaults++;
+    stats.windowFaults++;
     // Find a free frame or evict one
     size_t frameNumber;
-    if (!freeFrames.empty()) {
-        frameNumber = freeFrames.front();
-        freeFrames.pop();
+    if (!acquireFrame(frameNumber)) {
+        return false;
+    }
+
+    // Only faults that read the backing store are major
+    if (entry.isSwapped()) {
+        accounting[processId].majorFaults++;
     }
     else {
-        // No free frames, need to evict a page
-        frameNumber = findVictimFrame();
-        if (!swapOut(frameNumber)) {
-            return false;
-        }
+        accounting[processId].minorFaults++;
     }
 
     // Load page into physical memory
-    if (entry.backingStoreOffset > 0) {
+    if (entry.isSwapped() || entry.isCompressed()) {
         // Page exists in backing store, swap it in
         if (!swapIn(processId, pageNumber, frameNumber)) {
             freeFrames.push(frameNumber);
@@ -143,258 +180,740 @@ bool DemandPagingAllocator::accessPage(size_t processId, size_t pageNumber, bool
     }
 
     // Update page table entry
-    entry.present = true;
-    entry.referenced = true;
-    entry.frameNumber = frameNumber;
+    entry.setNumber(frameNumber);
+    entry.setFlag(PageTableEntry::ZERO, false);
+    entry.setFlag(PageTableEntry::PRESENT, true);
+    entry.setFlag(PageTableEntry::REFERENCED, true);
     if (isWrite) {
-        entry.dirty = true;
+        entry.setFlag(PageTableEntry::DIRTY, true);
     }
 
     // Update frame information
-    frames[frameNumber].occupied = true;
-    frames[frameNumber].processId = processId;
-    frames[frameNumber].pageNumber = pageNumber;
-    frames[frameNumber].lastAccessed = std::chrono::steady_clock::now();
+    frames.assign(frameNumber, static_cast<uint32_t>(processId), static_cast<uint32_t>(pageNumber));
+    frames.lastAccessed[frameNumber] = ++accessClock;
 
     usedFrames++;
     numPagedIn++;
+    addResident(processId);
 
     return true;
 }
 
-size_t DemandPagingAllocator::findVictimFrame() {
-    // LRU (Least Recently Used) page replacement algorithm
-    size_t victimFrame = 0;
-    auto oldestTime = std::chrono::steady_clock::now();
+bool DemandPagingAllocator::breakCopyOnWrite(size_t processId, size_t pageNumber, PageTableEntry& entry) {
+    size_t sharedFrame = entry.getFrameNumber();
+    ProcessPagingStats& stats = processStats[processId];
 
-    for (size_t i = 0; i < maxFrames; ++i) {
-        if (frames[i].occupied && frames[i].lastAccessed < oldestTime) {
-            oldestTime = frames[i].lastAccessed;
-            victimFrame = i;
+    if (!sharedMappers.count(sharedFrame)) {
+        // Every other mapper already has its own copy, so the frame is private now
+        entry.setFlag(PageTableEntry::COPY_ON_WRITE, false);
+    }
+    else {
+        // Copy-on-write fault: give this process a private copy of the shared frame
+        numPageFaults++;
+        numCowFaults++;
+        accounting[processId].minorFaults++;
+        windowFaults++;
+        stats.windowFaults++;
+
+        size_t frameNumber;
+        if (!acquireFrame(frameNumber, sharedFrame)) {
+            return false;
         }
+        detachMapping(sharedFrame, processId, pageNumber);
+
+        entry.setNumber(frameNumber);
+        entry.setFlag(PageTableEntry::COPY_ON_WRITE, false);
+        frames.assign(frameNumber, static_cast<uint32_t>(processId), static_cast<uint32_t>(pageNumber));
+        usedFrames++;
     }
 
-    return victimFrame;
+    entry.setFlag(PageTableEntry::REFERENCED, true);
+    entry.setFlag(PageTableEntry::DIRTY, true);
+    frames.lastAccessed[entry.getFrameNumber()] = ++accessClock;
+    return true;
 }
 
-bool DemandPagingAllocator::swapOut(size_t frameNumber) {
-    if (frameNumber >= frames.size() || !frames[frameNumber].occupied) {
+bool DemandPagingAllocator::cloneProcess(std::shared_ptr<Process> parent, std::shared_ptr<Process> child) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t parentId = parent->getPID();
+    size_t childId = child->getPID();
+    if (parentId >= pageDirectory.size() || pageDirectory[parentId].empty()) {
         return false;
     }
 
-    FrameInfo& frame = frames[frameNumber];
-    size_t processId = frame.processId;
-    size_t pageNumber = frame.pageNumber;
+    if (pageDirectory.size() <= childId) {
+        pageDirectory.resize(childId + 1);
+        processStats.resize(childId + 1);
+    }
+    if (accounting.size() <= childId) {
+        accounting.resize(childId + 1);
+    }
+    pageDirectory[childId] = PageTable(pageDirectory[parentId].size());
+    processStats[childId] = ProcessPagingStats{};
+    accounting[childId] = ProcessMemoryAccounting{};
+    PageTable& childTable = pageDirectory[childId];
+
+    // Resident pages are shared copy-on-write; swapped pages get their own copy.
+    // A page that cannot be copied fails the whole clone.
+    bool failed = false;
+    std::vector<size_t> marked;     // parent pages this clone made copy-on-write
+    pageDirectory[parentId].forEach([&](size_t pageNumber, PageTableEntry& entry) {
+        if (entry.bits == 0 || failed) {
+            return;
+        }
+        PageTableEntry& copy = *childTable.touch(pageNumber);
 
-    auto pageTableIt = processPageTables.find(processId);
-    if (pageTableIt == processPageTables.end() || pageNumber >= pageTableIt->second.size()) {
+        if (entry.isPresent()) {
+            size_t frameNumber = entry.getFrameNumber();
+            if (!entry.isCopyOnWrite()) {
+                marked.push_back(pageNumber);
+            }
+            entry.setFlag(PageTableEntry::COPY_ON_WRITE, true);
+            copy.bits = entry.bits & (PageTableEntry::PRESENT | PageTableEntry::DIRTY | PageTableEntry::COPY_ON_WRITE);
+            copy.setNumber(frameNumber);
+            sharedMappers[frameNumber].push_back(
+                FrameMapping{ static_cast<uint32_t>(childId), static_cast<uint32_t>(pageNumber) });
+            addResident(childId);
+        }
+        else if (entry.isZero()) {
+            copy.bits = PageTableEntry::ZERO;
+        }
+        else if (entry.isCompressed()) {
+            if (swapCache.duplicate(CompressedSwapCache::makeKey(parentId, pageNumber),
+                CompressedSwapCache::makeKey(childId, pageNumber))) {
+                copy.bits = PageTableEntry::COMPRESSED;
+                accounting[childId].swappedPages++;
+            }
+            else {
+                failed = true;
+            }
+        }
+        else if (entry.isSwapped()) {
+            std::vector<char> pageData(frameSize);
+            size_t slot = chooseSwapSlot(childId, pageNumber);
+            if (backingStore.readSlot(entry.getSwapSlot(), pageData.data()) && backingStore.writeSlot(slot, pageData.data())) {
+                copy.bits = PageTableEntry::SWAPPED;
+                copy.setNumber(slot);
+                processStats[childId].lastSwapSlot = slot;
+                backingStoreSize++;
+                accounting[childId].swappedPages++;
+                accounting[childId].bytesWritten += frameSize;
+            }
+            else {
+                backingStore.freeSlot(slot);
+                failed = true;
+            }
+        }
+    });
+
+    if (failed) {
+        // Take back every mapping and copy the child was given, and the parent's marks
+        releasePages(childId);
+        accounting[childId] = ProcessMemoryAccounting{};
+        for (size_t pageNumber : marked) {
+            PageTableEntry* entry = findEntry(parentId, pageNumber);
+            if (!sharedMappers.count(entry->getFrameNumber())) {
+                entry->setFlag(PageTableEntry::COPY_ON_WRITE, false);
+            }
+        }
         return false;
     }
 
-    PageTableEntry& entry = pageTableIt->second[pageNumber];
+    writeBackSwapCache();
+    return true;
+}
 
-    // Only write to backing store if page is dirty
-    if (entry.dirty) {
-        size_t backingStoreOffset = allocateBackingStoreSlot();
+PageTableEntry* DemandPagingAllocator::findEntry(size_t processId, size_t pageNumber) {
+    if (processId >= pageDirectory.size()) {
+        return nullptr;
+    }
+    return pageDirectory[processId].find(pageNumber);
+}
 
-        // Write page data to backing store
-        backingStore.seekp(backingStoreOffset * frameSize);
-        std::vector<char> pageData(frameSize, 0); // Simulate page data
-        backingStore.write(pageData.data(), frameSize);
-        backingStore.flush();
+size_t DemandPagingAllocator::findVictimFrame(size_t keepFrame) {
+    // LRU (Least Recently Used) page replacement algorithm.
+    // Shared frames are only chosen when nothing private is left to evict.
+    size_t victimFrame = keepFrame;
+    size_t sharedVictim = keepFrame;
+    uint64_t oldestStamp = UINT64_MAX;
+    uint64_t oldestShared = UINT64_MAX;
 
-        entry.backingStoreOffset = backingStoreOffset;
-        backingStoreSize++;
+    for (size_t i = 0; i < maxFrames; ++i) {
+        if (!frames.isOccupied(i) || i == keepFrame) continue;
+        if (!sharedMappers.empty() && sharedMappers.count(i)) {
+            if (frames.lastAccessed[i] < oldestShared) {
+                oldestShared = frames.lastAccessed[i];
+                sharedVictim = i;
+            }
+        }
+        else if (frames.lastAccessed[i] < oldestStamp) {
+            oldestStamp = frames.lastAccessed[i];
+            victimFrame = i;
+        }
     }
 
-    // Update page table entry
-    entry.present = false;
-    entry.dirty = false;
-    entry.referenced = false;
+    return victimFrame != keepFrame ? victimFrame : sharedVictim;
+}
 
-    // Free the frame
-    frame.occupied = false;
-    frame.processId = 0;
-    frame.pageNumber = 0;
-    usedFrames--;
+void DemandPagingAllocator::closeWorkingSetWindow() {
+    // Working set = pages referenced during the window, resident or already evicted.
+    // Suspended processes keep the working set they had when they were swapped out.
+    for (ProcessPagingStats& stats : processStats) {
+        if (!stats.suspended) {
+            stats.workingSet = stats.windowEvictedRefs;
+        }
+    }
+    for (size_t i = 0; i < maxFrames; ++i) {
+        if (!frames.isOccupied(i)) continue;
+        PageTableEntry* entry = findEntry(frames.owner[i], frames.pageNumber[i]);
+        if (entry && entry->isReferenced()) {
+            processStats[frames.owner[i]].workingSet++;
+            entry->setFlag(PageTableEntry::REFERENCED, false);
+        }
+    }
+    for (const auto& [frameNumber, mappings] : sharedMappers) {
+        for (const FrameMapping& mapping : mappings) {
+            PageTableEntry* entry = findEntry(mapping.processId, mapping.pageNumber);
+            if (entry && entry->isReferenced()) {
+                processStats[mapping.processId].workingSet++;
+                entry->setFlag(PageTableEntry::REFERENCED, false);
+            }
+        }
+    }
 
-    return true;
+    size_t total = 0;
+    for (ProcessPagingStats& stats : processStats) {
+        if (stats.suspended) continue;
+        stats.faultFrequency = stats.windowAccesses > 0
+            ? static_cast<double>(stats.windowFaults) / stats.windowAccesses : 0.0;
+        stats.windowAccesses = 0;
+        stats.windowFaults = 0;
+        stats.windowEvictedRefs = 0;
+        total += stats.workingSet;
+    }
+
+    double rate = windowAccesses > 0 ? static_cast<double>(windowFaults) / windowAccesses : 0.0;
+    faultRate = rate;
+    totalWorkingSet = total;
+    // Thrashing: most accesses fault and the active working sets no longer fit in memory
+    thrashing = rate > thrashingFaultRate && total > maxFrames;
+
+    windowAccesses = 0;
+    windowFaults = 0;
 }
 
-bool DemandPagingAllocator::swapIn(size_t processId, size_t pageNumber, size_t frameNumber) {
-    auto pageTableIt = processPageTables.find(processId);
-    if (pageTableIt == processPageTables.end() || pageNumber >= pageTableIt->second.size()) {
-        return false;
+void DemandPagingAllocator::suspendProcess(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t processId = process->getPID();
+    if (processId >= pageDirectory.size()) {
+        return;
     }
 
-    PageTableEntry& entry = pageTableIt->second[pageNumber];
+    // Swap out every resident page so the frames go back to the active processes
+    size_t evicted = 0;
+    pageDirectory[processId].forEach([&](size_t pageNumber, PageTableEntry& entry) {
+        if (entry.isPresent() && sharedMappers.count(entry.getFrameNumber())) {
+            // Only this process's mapping goes out, the frame stays with the other sharers
+            size_t frameNum = entry.getFrameNumber();
+            if (writeOutPage(processId, pageNumber, entry)) {
+                detachMapping(frameNum, processId, pageNumber);
+                evicted++;
+            }
+        }
+        else if (entry.isPresent()) {
+            size_t frameNum = entry.getFrameNumber();
+            if (swapOut(frameNum)) {
+                freeFrames.push(frameNum);
+                evicted++;
+            }
+        }
+    });
 
-    if (entry.backingStoreOffset == 0) {
-        return false; // Page not in backing store
-    }
+    writeBackSwapCache();
 
-    // Read page data from backing store
-    backingStore.seekg(entry.backingStoreOffset * frameSize);
-    std::vector<char> pageData(frameSize);
-    backingStore.read(pageData.data(), frameSize);
+    ProcessPagingStats& stats = processStats[processId];
+    stats.suspended = true;
+    stats.workingSet = std::max(stats.workingSet, size_t{ 1 });
+    numPagedOut += evicted;
 
-    if (!backingStore.good()) {
-        return false;
+    // Give the remaining processes one window to settle before suspending another
+    thrashing = false;
+}
+
+bool DemandPagingAllocator::canResume(std::shared_ptr<Process> process) const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t processId = process->getPID();
+    if (processId >= processStats.size()) {
+        return true;
     }
 
-    // Free the backing store slot
-    deallocateBackingStoreSlot(entry.backingStoreOffset);
-    entry.backingStoreOffset = 0;
-    backingStoreSize--;
-    return true;
+    size_t workingSet = processStats[processId].workingSet;
+    return !thrashing.load()
+        && totalWorkingSet.load() + workingSet <= maxFrames
+        && freeFrames.size() >= workingSet;
 }
 
-size_t DemandPagingAllocator::allocateBackingStoreSlot() {
-    if (!freeBackingStoreSlots.empty()) {
-        size_t slot = freeBackingStoreSlots.front();
-        freeBackingStoreSlots.pop();
-        return slot;
+void DemandPagingAllocator::resumeProcess(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t processId = process->getPID();
+    if (processId < processStats.size()) {
+        processStats[processId].suspended = false;
+        totalWorkingSet += processStats[processId].workingSet;
     }
-    return nextBackingStoreOffset++;
 }
 
-void DemandPagingAllocator::deallocateBackingStoreSlot(size_t offset) {
-    freeBackingStoreSlots.push(offset);
+void DemandPagingAllocator::addResident(size_t processId) {
+    ProcessMemoryAccounting& usage = accounting[processId];
+    usage.residentPages++;
+    usage.peakResident = std::max(usage.peakResident, usage.residentPages);
 }
 
-std::string DemandPagingAllocator::visualizeMemory() {
+ProcessMemoryAccounting DemandPagingAllocator::getProcessAccounting(size_t processId) const {
     std::lock_guard<std::mutex> lock(allocatorMutex);
-    std::ostringstream oss;
 
-    oss << "=== Demand Paging Memory Visualization ===\n";
-    oss << "Physical Frames (" << maxFrames << " total):\n";
+    if (processId >= accounting.size()) {
+        return ProcessMemoryAccounting{};
+    }
+    return accounting[processId];
+}
 
-    for (size_t i = 0; i < maxFrames; ++i) {
-        oss << "Frame " << i << ": ";
-        if (frames[i].occupied) {
-            oss << "Process " << frames[i].processId << ", Page " << frames[i].pageNumber;
-        }
-        else {
-            oss << "Free";
-        }
-        oss << "\n";
+ProcessPagingStats DemandPagingAllocator::getProcessStats(size_t processId) const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    if (processId >= processStats.size()) {
+        return ProcessPagingStats{};
     }
+    return processStats[processId];
+}
 
-    oss << "\nProcess Page Tables:\n";
-    for (const auto& [processId, pageTable] : processPageTables) {
-        oss << "Process " << processId << ":\n";
-        for (size_t pageNum = 0; pageNum < pageTable.size(); ++pageNum) {
-            const PageTableEntry& entry = pageTable[pageNum];
-            oss << "  Page " << pageNum << ": ";
-            if (entry.present) {
-                oss << "Frame " << entry.frameNumber;
-                if (entry.dirty) oss << " (dirty)";
-                if (entry.referenced) oss << " (ref)";
-            }
-            else if (entry.backingStoreOffset > 0) {
-                oss << "Swapped (offset " << entry.backingStoreOffset << ")";
-            }
-            else {
-                oss << "Not allocated";
+bool DemandPagingAllocator::swapOut(size_t frameNumber) {
+    if (frameNumber >= maxFrames || !frames.isOccupied(frameNumber)) {
+        return false;
+    }
+
+    size_t processId = frames.owner[frameNumber];
+    size_t pageNumber = frames.pageNumber[frameNumber];
+
+    PageTableEntry* entryPtr = findEntry(processId, pageNumber);
+    if (!entryPtr) {
+        return false;
+    }
+
+    // A shared frame is evicted for every process mapping it, each getting its own copy.
+    // All copies are stored before any page table changes, so a failed write leaves the
+    // frame and every mapping of it as they were.
+    std::vector<FrameMapping> mappings{ { static_cast<uint32_t>(processId), static_cast<uint32_t>(pageNumber) } };
+    auto shared = sharedMappers.find(frameNumber);
+    if (shared != sharedMappers.end()) {
+        mappings.insert(mappings.end(), shared->second.begin(), shared->second.end());
+    }
+
+    std::vector<PageCopy> copies(mappings.size());
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        PageTableEntry* entry = findEntry(mappings[i].processId, mappings[i].pageNumber);
+        if (entry && !storePage(mappings[i].processId, mappings[i].pageNumber, *entry, copies[i])) {
+            for (size_t j = 0; j < i; ++j) {
+                discardPage(mappings[j].processId, mappings[j].pageNumber, copies[j]);
             }
-            oss << "\n";
+            return false;
         }
     }
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        if (PageTableEntry* entry = findEntry(mappings[i].processId, mappings[i].pageNumber)) {
+            commitPage(mappings[i].processId, *entry, copies[i]);
+        }
+    }
+    if (shared != sharedMappers.end()) {
+        sharedMappers.erase(shared);
+    }
 
-    oss << "\nStatistics:\n";
-    oss << "Page faults: " << numPageFaults.load() << "\n";
-    oss << "Pages in memory: " << usedFrames.load() << "/" << maxFrames << "\n";
-    oss << "Pages in backing store: " << backingStoreSize.load() << "\n";
-    oss << "Total pages allocated: " << numPagedIn.load() << "\n";
-    oss << "Total pages evicted: " << numPagedOut.load() << "\n";
+    // Free the frame
+    frames.release(frameNumber);
+    usedFrames--;
 
-    oss << "==========================================\n";
+    writeBackSwapCache();
+    return true;
+}
 
-    return oss.str();
+bool DemandPagingAllocator::writeOutPage(size_t processId, size_t pageNumber, PageTableEntry& entry) {
+    PageCopy copy;
+    if (!storePage(processId, pageNumber, entry, copy)) {
+        return false;
+    }
+    commitPage(processId, entry, copy);
+    return true;
 }
 
-// Implement FlatMemoryAllocator methods that were missing
-FlatMemoryAllocator::FlatMemoryAllocator(size_t maximumSize, size_t memPerProcSize)
-    : maxSize(maximumSize), memPerProc(memPerProcSize) {
-    initializeMemory();
+bool DemandPagingAllocator::storePage(size_t processId, size_t pageNumber, const PageTableEntry& entry, PageCopy& copy) {
+    // Only write to backing store if page is dirty
+    if (!entry.isDirty()) {
+        return true;
+    }
+    std::vector<char> pageData(frameSize);
+    fillPageData(processId, pageNumber, pageData.data());
+    if (swapCache.enabled()
+        && swapCache.store(CompressedSwapCache::makeKey(processId, pageNumber), pageData.data(), frameSize)) {
+        // Compressed in memory, the file is only written if the cache overflows
+        copy.compressed = true;
+        return true;
+    }
+
+    // Write page data to backing store
+    copy.slot = chooseSwapSlot(processId, pageNumber);
+    if (!backingStore.writeSlot(copy.slot, pageData.data())) {
+        backingStore.freeSlot(copy.slot);
+        return false;
+    }
+    copy.swapped = true;
+    return true;
+}
+
+void DemandPagingAllocator::discardPage(size_t processId, size_t pageNumber, const PageCopy& copy) {
+    if (copy.compressed) {
+        swapCache.erase(CompressedSwapCache::makeKey(processId, pageNumber));
+    }
+    else if (copy.swapped) {
+        backingStore.freeSlot(copy.slot);
+    }
 }
 
-void* FlatMemoryAllocator::allocate(std::shared_ptr<Process> process) {
-    size_t requiredSize = process->getMemoryRequired();
+void DemandPagingAllocator::commitPage(size_t processId, PageTableEntry& entry, const PageCopy& copy) {
+    // A page referenced in this window still belongs to the working set after eviction
+    if (entry.isReferenced()) {
+        processStats[processId].windowEvictedRefs++;
+    }
 
-    // Find a free block of sufficient size
-    for (size_t i = 0; i <= maxSize - requiredSize; i += memPerProc) {
-        if (canAllocateAt(i, requiredSize)) {
-            allocateAt(i, requiredSize);
-            processMap[i] = process->getPID();
-            return reinterpret_cast<void*>(i + 1); // Return non-zero pointer
-        }
+    ProcessMemoryAccounting& usage = accounting[processId];
+    if (copy.compressed) {
+        numSwapCacheStores++;
+    }
+    else if (copy.swapped) {
+        processStats[processId].lastSwapSlot = copy.slot;
+        backingStoreSize++;
+        usage.bytesWritten += frameSize;
+    }
+    usage.residentPages--;
+    if (copy.swapped || copy.compressed) {
+        usage.swappedPages++;
     }
 
-    return nullptr; // No space available
+    // Update page table entry
+    entry.bits = 0;
+    entry.setNumber(copy.slot);
+    entry.setFlag(PageTableEntry::SWAPPED, copy.swapped);
+    entry.setFlag(PageTableEntry::COMPRESSED, copy.compressed);
 }
 
-void FlatMemoryAllocator::deallocate(std::shared_ptr<Process> process) {
-    size_t processId = process->getPID();
+void DemandPagingAllocator::detachMapping(size_t frameNumber, size_t processId, size_t pageNumber) {
+    auto shared = sharedMappers.find(frameNumber);
+    if (shared == sharedMappers.end()) {
+        return;
+    }
 
-    for (auto it = processMap.begin(); it != processMap.end(); ++it) {
-        if (it->second == processId) {
-            deallocateAt(it->first);
-            processMap.erase(it);
-            break;
-        }
+    std::vector<FrameMapping>& mappings = shared->second;
+    if (frames.owner[frameNumber] == processId && frames.pageNumber[frameNumber] == pageNumber) {
+        // The owner leaves, so one of the sharers takes over the frame
+        FrameMapping heir = mappings.back();
+        mappings.pop_back();
+        frames.assign(frameNumber, heir.processId, heir.pageNumber);
+    }
+    else {
+        std::erase_if(mappings, [&](const FrameMapping& m) {
+            return m.processId == processId && m.pageNumber == pageNumber;
+        });
+    }
+
+    if (mappings.empty()) {
+        sharedMappers.erase(shared);
     }
 }
 
-std::string FlatMemoryAllocator::visualizeMemory() {
-    std::ostringstream oss;
-    oss << "Flat Memory Visualization:\n";
+bool DemandPagingAllocator::acquireFrame(size_t& frameNumber, size_t keepFrame) {
+    if (!freeFrames.empty()) {
+        frameNumber = freeFrames.front();
+        freeFrames.pop();
+        return true;
+    }
 
-    for (size_t i = 0; i < maxSize; i += memPerProc) {
-        auto procIt = processMap.find(i);
-        if (procIt != processMap.end()) {
-            oss << "Block " << i / memPerProc << " -> Process " << procIt->second << "\n";
+    // No free frames, need to evict a page
+    frameNumber = findVictimFrame(keepFrame);
+    return frameNumber != keepFrame && swapOut(frameNumber);
+}
+
+bool DemandPagingAllocator::swapIn(size_t processId, size_t pageNumber, size_t frameNumber) {
+    PageTableEntry* entryPtr = findEntry(processId, pageNumber);
+    if (!entryPtr) {
+        return false;
+    }
+
+    PageTableEntry& entry = *entryPtr;
+
+    if (entry.isCompressed()) {
+        // Served from the compressed cache, no file read needed
+        std::vector<char> pageData(frameSize);
+        if (!swapCache.load(CompressedSwapCache::makeKey(processId, pageNumber), pageData.data(), frameSize)) {
+            return false;
+        }
+        entry.setFlag(PageTableEntry::COMPRESSED, false);
+        entry.setFlag(PageTableEntry::DIRTY, true);
+        numSwapCacheHits++;
+        accounting[processId].swappedPages--;
+        return true;
+    }
+
+    if (!entry.isSwapped()) {
+        return false; // Page not in backing store
+    }
+
+    // Neighbouring pages swapped out to the following slots come along in the
+    // same read. Free frames are used first; LRU frames are only reclaimed for
+    // readahead while at least half of the recent readahead pages were used.
+    size_t slot = entry.getSwapSlot();
+    bool mayEvict = recentReadahead == 0 || recentReadaheadHits * 2 >= recentReadahead;
+    std::vector<PageTableEntry*> readahead;
+    std::vector<size_t> readaheadFrames;
+    while (readahead.size() < readaheadWindow) {
+        PageTableEntry* next = findEntry(processId, pageNumber + readahead.size() + 1);
+        if (!next || !next->isSwapped() || next->getSwapSlot() != slot + readahead.size() + 1) {
+            break;
+        }
+        if (!freeFrames.empty()) {
+            readaheadFrames.push_back(freeFrames.front());
+            freeFrames.pop();
+        }
+        else if (!mayEvict || usedFrames == 0) {
+            break;
         }
         else {
-            oss << "Block " << i / memPerProc << " -> Free\n";
+            size_t victim = findVictimFrame();
+            if (!swapOut(victim)) {
+                break;
+            }
+            readaheadFrames.push_back(victim);
         }
+        readahead.push_back(next);
     }
 
-    return oss.str();
-}
+    // Read page data from backing store
+    std::vector<char> pageData(frameSize * (readahead.size() + 1));
+    if (!backingStore.readSlots(slot, readahead.size() + 1, pageData.data())) {
+        for (size_t frame : readaheadFrames) {
+            freeFrames.push(frame);
+        }
+        return false;
+    }
 
-void FlatMemoryAllocator::initializeMemory() {
-    memory.resize(maxSize, 0);
+    // Free the backing store slot; the frame now holds the only copy
+    backingStore.freeSlot(slot);
+    entry.setFlag(PageTableEntry::SWAPPED, false);
+    entry.setFlag(PageTableEntry::DIRTY, true);
+    entry.setNumber(0);
+    backingStoreSize--;
+    accounting[processId].swappedPages -= readahead.size() + 1;
+
+    // Map the readahead pages without marking them referenced
+    for (size_t i = 0; i < readahead.size(); ++i) {
+        PageTableEntry& next = *readahead[i];
+        size_t nextFrame = readaheadFrames[i];
+
+        backingStore.freeSlot(next.getSwapSlot());
+        next.bits = PageTableEntry::PRESENT | PageTableEntry::DIRTY | PageTableEntry::READAHEAD;
+        next.setNumber(nextFrame);
+
+        frames.assign(nextFrame, static_cast<uint32_t>(processId), static_cast<uint32_t>(pageNumber + i + 1));
+        frames.lastAccessed[nextFrame] = accessClock;
+        usedFrames++;
+        numPagedIn++;
+        backingStoreSize--;
+        addResident(processId);
+    }
+    numReadaheadPages += readahead.size();
+    recentReadahead += readahead.size();
+    if (recentReadahead >= 256) {
+        recentReadahead /= 2;
+        recentReadaheadHits /= 2;
+    }
+    return true;
+}
 
-    for (size_t i = 0; i < maxSize; i += memPerProc) {
-        allocationMap[i] = false;
+size_t DemandPagingAllocator::chooseSwapSlot(size_t processId, size_t pageNumber) {
+    // Keep a process's pages together: right after the previous page's slot,
+    // right before the next page's slot, or after this process's last swap-out
+    PageTableEntry* prev = pageNumber > 0 ? findEntry(processId, pageNumber - 1) : nullptr;
+    if (prev && prev->isSwapped() && !backingStore.isSlotUsed(prev->getSwapSlot() + 1)) {
+        return backingStore.allocateSlot(prev->getSwapSlot() + 1);
+    }
+    PageTableEntry* next = findEntry(processId, pageNumber + 1);
+    if (next && next->isSwapped() && next->getSwapSlot() > 0 && !backingStore.isSlotUsed(next->getSwapSlot() - 1)) {
+        return backingStore.allocateSlot(next->getSwapSlot() - 1);
     }
+    size_t lastSlot = processStats[processId].lastSwapSlot;
+    if (lastSlot != SIZE_MAX) {
+        return backingStore.allocateSlot(lastSlot + 1);
+    }
+    return backingStore.allocateSlot();
 }
 
-bool FlatMemoryAllocator::canAllocateAt(size_t index, size_t size) const {
-    size_t blocksNeeded = (size + memPerProc - 1) / memPerProc;
+void DemandPagingAllocator::writeBackSwapCache() {
+    while (swapCache.overBudget()) {
+        uint64_t key;
+        std::vector<char> pageData;
+        if (!swapCache.popOldest(key, pageData, frameSize)) {
+            continue;
+        }
+
+        size_t processId = CompressedSwapCache::keyProcess(key);
+        size_t pageNumber = CompressedSwapCache::keyPage(key);
+        PageTableEntry* entry = findEntry(processId, pageNumber);
+        if (!entry) {
+            continue;
+        }
 
-    for (size_t i = 0; i < blocksNeeded; ++i) {
-        size_t blockIndex = index + (i * memPerProc);
-        if (blockIndex >= maxSize || allocationMap.at(blockIndex)) {
-            return false;
+        size_t slot = chooseSwapSlot(processId, pageNumber);
+        if (!backingStore.writeSlot(slot, pageData.data())) {
+            // Keep the page in the cache over budget rather than lose it
+            backingStore.freeSlot(slot);
+            swapCache.store(key, pageData.data(), frameSize);
+            break;
         }
+
+        entry->bits = PageTableEntry::SWAPPED;
+        entry->setNumber(slot);
+        processStats[processId].lastSwapSlot = slot;
+        backingStoreSize++;
+        numSwapCacheWritebacks++;
+        accounting[processId].bytesWritten += frameSize;
     }
+}
+
+void DemandPagingAllocator::fillPageData(size_t processId, size_t pageNumber, char* data) const {
+    // Simulated contents: the owning PID and page number, the rest zero
+    std::fill_n(data, frameSize, 0);
+    uint32_t header[2] = { static_cast<uint32_t>(processId), static_cast<uint32_t>(pageNumber) };
+    std::memcpy(data, header, std::min(sizeof(header), frameSize));
+}
 
+void DemandPagingAllocator::setSwapCacheBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    swapCache.setBudget(bytes);
+    writeBackSwapCache();
+}
+
+SwapCacheStats DemandPagingAllocator::getSwapCacheStats() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    SwapCacheStats stats;
+    stats.entries = swapCache.getEntries();
+    stats.storedBytes = swapCache.getStoredBytes();
+    stats.budget = swapCache.getBudget();
+    if (swapCache.getCompressedBytes() > 0) {
+        stats.compressionRatio = static_cast<double>(swapCache.getOriginalBytes()) / swapCache.getCompressedBytes();
+    }
+    stats.stores = numSwapCacheStores;
+    stats.hits = numSwapCacheHits;
+    stats.writebacks = numSwapCacheWritebacks;
+    return stats;
+}
+
+size_t DemandPagingAllocator::getBackingStoreFileSize() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return backingStore.getFileSize();
+}
+
+size_t DemandPagingAllocator::getBackingStoreBytesPunched() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return backingStore.getBytesPunched();
+}
+
+bool DemandPagingAllocator::startTrace(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    auto writer = std::make_unique<AccessTraceWriter>(fileName, frameSize);
+    if (!writer->isOpen()) {
+        return false;
+    }
+    trace = std::move(writer);
     return true;
 }
 
-void FlatMemoryAllocator::allocateAt(size_t index, size_t size) {
-    size_t blocksNeeded = (size + memPerProc - 1) / memPerProc;
+size_t DemandPagingAllocator::getTracedAccesses() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return trace ? trace->getRecords() : 0;
+}
 
-    for (size_t i = 0; i < blocksNeeded; ++i) {
-        size_t blockIndex = index + (i * memPerProc);
-        allocationMap[blockIndex] = true;
+std::string DemandPagingAllocator::visualizeMemory(bool changedOnly) {
+    // Snapshot frame owners without the allocator lock so cores keep running
+    std::vector<uint32_t> owners(maxFrames);
+    std::map<uint32_t, size_t> residentFrames;
+    for (size_t i = 0; i < maxFrames; ++i) {
+        owners[i] = frames.loadOwner(i);
+        if (!changedOnly && owners[i] != FrameTable::NO_OWNER) {
+            residentFrames[owners[i]]++;
+        }
     }
 
-    allocatedSize += size;
+    std::ostringstream oss;
+
+    oss << "=== Demand Paging Memory Visualization ===\n";
+    oss << "Physical Frames (" << maxFrames << " total):\n";
+    oss << view.render(std::move(owners), "Frame", changedOnly);
+
+    if (!changedOnly) {
+        oss << "\nResident Frames per Process:\n";
+        for (const auto& [processId, count] : residentFrames) {
+            oss << "Process " << processId << ": " << count << " frames\n";
+        }
+
+        oss << "\nStatistics:\n";
+        oss << "Page faults: " << numPageFaults.load() << "\n";
+        oss << "Pages in memory: " << usedFrames.load() << "/" << maxFrames << "\n";
+        oss << "Pages in backing store: " << backingStoreSize.load() << "\n";
+        oss << "Total pages allocated: " << numPagedIn.load() << "\n";
+        oss << "Total pages evicted: " << numPagedOut.load() << "\n";
+    }
+
+    oss << "==========================================\n";
+
+    return oss.str();
 }
 
-void FlatMemoryAllocator::deallocateAt(size_t index) {
-    allocationMap[index] = false;
+std::string DemandPagingAllocator::footprintReport() const {
+    // Layouts used before the packed page table / frame table
+    struct LegacyPageTableEntry { bool present, dirty, referenced; size_t frameNumber, backingStoreOffset; };
+    struct LegacyFrameInfo { bool occupied; size_t processId, pageNumber; std::chrono::steady_clock::time_point lastAccessed; };
+    // unordered_map node (next pointer + cached hash + key/value pair) plus one bucket pointer
+    const size_t legacyNodeSize = sizeof(void*) * 2 + sizeof(std::pair<const size_t, std::vector<LegacyPageTableEntry>>) + sizeof(void*);
+
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t processes = 0;
+    size_t pages = 0;
+    size_t mappedEntries = 0;
+    size_t packedPageTables = pageDirectory.capacity() * sizeof(PageTable);
+    for (const PageTable& pageTable : pageDirectory) {
+        if (pageTable.empty()) continue;
+        processes++;
+        pages += pageTable.size();
+        mappedEntries += pageTable.getAllocatedEntries();
+        packedPageTables += pageTable.footprintBytes() - sizeof(PageTable);
+    }
+
+    size_t legacyPageTables = pages * sizeof(LegacyPageTableEntry) + processes * legacyNodeSize;
+    size_t legacyFrames = maxFrames * sizeof(LegacyFrameInfo);
+    size_t packedFrames = maxFrames * frames.bytesPerFrame();
+
+    std::ostringstream oss;
+    oss << "=== Paging Metadata Footprint ===\n";
+    oss << "Processes: " << processes << ", Pages: " << pages << " (" << mappedEntries << " entries mapped), Frames: " << maxFrames << "\n";
+    oss << std::left << std::setw(14) << "Structure" << std::setw(16) << "Old (bytes)" << std::setw(16) << "New (bytes)" << "\n";
+    oss << std::setw(14) << "Page tables" << std::setw(16) << legacyPageTables << std::setw(16) << packedPageTables << "\n";
+    oss << std::setw(14) << "Frame table" << std::setw(16) << legacyFrames << std::setw(16) << packedFrames << "\n";
+    oss << std::setw(14) << "Total" << std::setw(16) << legacyPageTables + legacyFrames << std::setw(16) << packedPageTables + packedFrames << "\n";
+    oss << "Bytes per PTE: " << sizeof(LegacyPageTableEntry) << " -> " << sizeof(PageTableEntry)
+        << ", bytes per frame: " << sizeof(LegacyFrameInfo) << " -> " << frames.bytesPerFrame() << "\n";
+    oss << "=================================\n";
+
+    return oss.str();
 }
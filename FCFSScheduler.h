@@ -8,11 +8,6 @@ public:
         : Scheduler(cores, allocator) {
     }
 
-    void addProcess(std::shared_ptr<Process> process) override;
     void schedulerThread() override;
     void cpuCoreThread(int coreID) override;
-
-private:
-    // Helper method to simulate page accesses during process execution
-    void simulatePageAccess(std::shared_ptr<Process> process, int coreID);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Fenwick (binary indexed) tree of non-negative weights addressed by a small
+// dense id (a slot index). set and the weighted search are O(log n), so a
+// lottery can draw among n ticket holders without scanning them.
+// Not thread-safe: callers serialize access, as with the ready queue.
+class FenwickTree {
+public:
+    uint64_t total() const { return sum; }
+    uint64_t get(uint32_t id) const { return id < weights.size() ? weights[id] : 0; }
+
+    void set(uint32_t id, uint64_t weight) {
+        if (id >= weights.size()) {
+            grow(id + 1);
+        }
+        uint64_t old = weights[id];
+        weights[id] = weight;
+        sum = sum - old + weight;
+        // Unsigned wraparound makes a decrease work as an addition
+        for (size_t i = id + 1; i <= tree.size(); i += i & (~i + 1)) {
+            tree[i - 1] += weight - old;
+        }
+    }
+
+    // Id whose weight covers point, a value in [0, total()): the first id
+    // whose running sum of weights exceeds point
+    uint32_t find(uint64_t point) const {
+        size_t position = 0;
+        for (size_t step = highestBit(tree.size()); step > 0; step >>= 1) {
+            if (position + step <= tree.size() && tree[position + step - 1] <= point) {
+                position += step;
+                point -= tree[position - 1];
+            }
+        }
+        return static_cast<uint32_t>(position);
+    }
+
+    void clear() {
+        weights.clear();
+        tree.clear();
+        sum = 0;
+    }
+
+private:
+    std::vector<uint64_t> weights;  // by id
+    std::vector<uint64_t> tree;     // tree[i - 1] sums weights (i - lowbit(i), i]
+    uint64_t sum = 0;
+
+    static size_t highestBit(size_t n) {
+        size_t bit = 1;
+        while (bit <= n / 2) {
+            bit <<= 1;
+        }
+        return n == 0 ? 0 : bit;
+    }
+
+    // Capacity doubles, and the tree is rebuilt in O(n) from the weights
+    void grow(size_t size) {
+        size_t capacity = weights.empty() ? 16 : weights.size();
+        while (capacity < size) {
+            capacity *= 2;
+        }
+        weights.resize(capacity, 0);
+        tree.assign(weights.begin(), weights.end());
+        for (size_t i = 1; i <= tree.size(); ++i) {
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= tree.size()) {
+                tree[parent - 1] += tree[i - 1];
+            }
+        }
+    }
+};
@@ -0,0 +1,304 @@
+#include "MemoryAllocator.h"
+#include <bit>
+
+FlatMemoryAllocator::FlatMemoryAllocator(size_t maximumSize, size_t blockSize, Policy policy)
+    : blockSize(std::max(size_t{ 1 }, blockSize)), totalBlocks(maximumSize / std::max(size_t{ 1 }, blockSize)), policy(policy) {
+
+    buddyFreeLists.resize(sizeClassOf(std::max(totalBlocks, size_t{ 1 })) + 1);
+
+    if (policy == Policy::BUDDY) {
+        // Cover memory with the largest aligned power-of-two blocks that fit
+        size_t start = 0;
+        while (start < totalBlocks) {
+            size_t order = sizeClassOf(totalBlocks - start);
+            while (start % (size_t{ 1 } << order) != 0) {
+                order--;
+            }
+            buddyFreeLists[order].insert(start);
+            start += size_t{ 1 } << order;
+        }
+    }
+    else if (totalBlocks > 0) {
+        runLengths.reset(totalBlocks);
+        insertFreeRun(0, totalBlocks);
+    }
+    freeBlocks = totalBlocks;
+}
+
+bool FlatMemoryAllocator::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "buddy") policy = Policy::BUDDY;
+    else if (name == "first-fit") policy = Policy::FIRST_FIT;
+    else if (name == "best-fit") policy = Policy::BEST_FIT;
+    else if (name == "next-fit") policy = Policy::NEXT_FIT;
+    else return false;
+    return true;
+}
+
+std::string FlatMemoryAllocator::policyName(Policy policy) {
+    switch (policy) {
+    case Policy::BUDDY: return "buddy";
+    case Policy::FIRST_FIT: return "first-fit";
+    case Policy::BEST_FIT: return "best-fit";
+    case Policy::NEXT_FIT: return "next-fit";
+    }
+    return "unknown";
+}
+
+// floor(log2(length)) for length >= 1
+size_t FlatMemoryAllocator::sizeClassOf(size_t length) {
+    return std::bit_width(length) - 1;
+}
+
+void* FlatMemoryAllocator::allocate(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    size_t processId = process->getPID();
+    auto existing = allocations.find(processId);
+    if (existing != allocations.end()) {
+        return reinterpret_cast<void*>(existing->second.start * blockSize + 1);
+    }
+
+    size_t requiredSize = std::max(process->getMemoryRequired(), size_t{ 1 });
+    size_t length = (requiredSize + blockSize - 1) / blockSize;
+    size_t start = totalBlocks;
+
+    if (policy == Policy::BUDDY) {
+        size_t order = std::bit_width(length - 1);   // ceil(log2(length))
+        if (order < buddyFreeLists.size()) {
+            start = allocateBuddy(order);
+            length = size_t{ 1 } << order;
+        }
+    }
+    else {
+        start = allocateRun(length);
+    }
+
+    if (start >= totalBlocks) {
+        return nullptr; // No space available
+    }
+
+    allocations[processId] = Allocation{ start, length, requiredSize };
+    freeBlocks -= length;
+    return reinterpret_cast<void*>(start * blockSize + 1); // Return non-zero pointer
+}
+
+void FlatMemoryAllocator::deallocate(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    auto it = allocations.find(process->getPID());
+    if (it == allocations.end()) {
+        return;
+    }
+
+    const Allocation& allocation = it->second;
+    if (policy == Policy::BUDDY) {
+        freeBuddy(allocation.start, sizeClassOf(allocation.blocks));
+    }
+    else {
+        freeRun(allocation.start, allocation.blocks);
+    }
+
+    freeBlocks += allocation.blocks;
+    allocations.erase(it);
+}
+
+/*============== FIT POLICIES ================*/
+void FlatMemoryAllocator::insertFreeRun(size_t start, size_t length) {
+    freeByAddress[start] = length;
+    freeBySize.insert({ length, start });
+    runLengths.set(start, length);
+}
+
+void FlatMemoryAllocator::eraseFreeRun(size_t start, size_t length) {
+    freeByAddress.erase(start);
+    freeBySize.erase({ length, start });
+    runLengths.set(start, 0);
+}
+
+bool FlatMemoryAllocator::findFit(size_t length, size_t& start) {
+    switch (policy) {
+    case Policy::BEST_FIT: {
+        // Smallest run that fits, lowest address on ties
+        auto it = freeBySize.lower_bound({ length, 0 });
+        if (it == freeBySize.end()) return false;
+        start = it->second;
+        return true;
+    }
+    case Policy::FIRST_FIT: {
+        // Lowest-addressed run that fits
+        start = runLengths.findFirst(0, length);
+        return start != MaxSegmentTree::NONE;
+    }
+    case Policy::NEXT_FIT: {
+        // Resume from the run where the last search stopped, wrapping around once
+        size_t from = nextFitCursor;
+        auto next = freeByAddress.upper_bound(nextFitCursor);
+        if (next != freeByAddress.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second > nextFitCursor) from = prev->first;
+        }
+        start = runLengths.findFirst(from, length);
+        if (start == MaxSegmentTree::NONE) {
+            start = runLengths.findFirst(0, length);    // nothing at or after from fits, so this is below it
+        }
+        return start != MaxSegmentTree::NONE;
+    }
+    default:
+        return false;
+    }
+}
+
+size_t FlatMemoryAllocator::allocateRun(size_t length) {
+    size_t start = 0;
+    if (!findFit(length, start)) {
+        return totalBlocks;
+    }
+
+    size_t runLength = freeByAddress[start];
+    eraseFreeRun(start, runLength);
+    if (runLength > length) {
+        insertFreeRun(start + length, runLength - length);
+    }
+    nextFitCursor = start + length;
+    return start;
+}
+
+void FlatMemoryAllocator::freeRun(size_t start, size_t length) {
+    // Coalesce with the neighbouring free runs
+    auto next = freeByAddress.lower_bound(start);
+    if (next != freeByAddress.end() && next->first == start + length) {
+        size_t nextLength = next->second;
+        eraseFreeRun(next->first, nextLength);
+        length += nextLength;
+    }
+
+    auto prev = freeByAddress.lower_bound(start);
+    if (prev != freeByAddress.begin()) {
+        --prev;
+        if (prev->first + prev->second == start) {
+            size_t prevStart = prev->first;
+            size_t prevLength = prev->second;
+            eraseFreeRun(prevStart, prevLength);
+            start = prevStart;
+            length += prevLength;
+        }
+    }
+
+    insertFreeRun(start, length);
+}
+
+/*============== BUDDY SYSTEM ================*/
+size_t FlatMemoryAllocator::allocateBuddy(size_t order) {
+    size_t current = order;
+    while (current < buddyFreeLists.size() && buddyFreeLists[current].empty()) {
+        current++;
+    }
+    if (current >= buddyFreeLists.size()) {
+        return totalBlocks;
+    }
+
+    size_t start = *buddyFreeLists[current].begin();
+    buddyFreeLists[current].erase(buddyFreeLists[current].begin());
+
+    // Split down to the requested order, keeping the upper halves free
+    while (current > order) {
+        current--;
+        buddyFreeLists[current].insert(start + (size_t{ 1 } << current));
+    }
+    return start;
+}
+
+void FlatMemoryAllocator::freeBuddy(size_t start, size_t order) {
+    while (order + 1 < buddyFreeLists.size()) {
+        size_t buddy = start ^ (size_t{ 1 } << order);
+        auto it = buddyFreeLists[order].find(buddy);
+        if (it == buddyFreeLists[order].end()) {
+            break;
+        }
+        buddyFreeLists[order].erase(it);
+        start = std::min(start, buddy);
+        order++;
+    }
+    buddyFreeLists[order].insert(start);
+}
+
+/*============== STATISTICS ================*/
+size_t FlatMemoryAllocator::getAllocatedSize() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return (totalBlocks - freeBlocks) * blockSize;
+}
+
+size_t FlatMemoryAllocator::getFreeSize() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return freeBlocks * blockSize;
+}
+
+size_t FlatMemoryAllocator::getLargestFreeBlock() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    if (policy == Policy::BUDDY) {
+        for (size_t order = buddyFreeLists.size(); order-- > 0;) {
+            if (!buddyFreeLists[order].empty()) {
+                return (size_t{ 1 } << order) * blockSize;
+            }
+        }
+        return 0;
+    }
+    return freeBySize.empty() ? 0 : freeBySize.rbegin()->first * blockSize;
+}
+
+size_t FlatMemoryAllocator::getNumFreeBlocks() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    if (policy == Policy::BUDDY) {
+        size_t count = 0;
+        for (const auto& freeList : buddyFreeLists) {
+            count += freeList.size();
+        }
+        return count;
+    }
+    return freeByAddress.size();
+}
+
+size_t FlatMemoryAllocator::getNumAllocations() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return allocations.size();
+}
+
+size_t FlatMemoryAllocator::getInternalFragmentation() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    size_t wasted = 0;
+    for (const auto& [pid, allocation] : allocations) {
+        wasted += allocation.blocks * blockSize - allocation.requested;
+    }
+    return wasted;
+}
+
+double FlatMemoryAllocator::getExternalFragmentation() const {
+    size_t freeSize = getFreeSize();
+    if (freeSize == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(getLargestFreeBlock()) / freeSize;
+}
+
+std::string FlatMemoryAllocator::visualizeMemory(bool changedOnly) {
+    // Copy the (few) allocated runs under the lock, expand them outside it
+    std::vector<std::pair<size_t, Allocation>> allocated;
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        allocated.reserve(allocations.size());
+        for (const auto& [pid, allocation] : allocations) {
+            allocated.push_back({ pid, allocation });
+        }
+    }
+
+    std::vector<uint32_t> owners(totalBlocks, MemoryView::FREE);
+    for (const auto& [pid, allocation] : allocated) {
+        std::fill_n(owners.begin() + allocation.start, allocation.blocks, static_cast<uint32_t>(pid));
+    }
+
+    std::ostringstream oss;
+    oss << "Flat Memory Visualization (" << policyName(policy) << ", " << blockSize << " bytes per block):\n";
+    oss << view.render(std::move(owners), "Block", changedOnly);
+
+    return oss.str();
+}
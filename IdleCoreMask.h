@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// One bit per simulated core, set while the core is idle, packed into 64-bit
+// atomic words (one cache line each, so cores in different words do not contend).
+// Finding an idle core is a find-first-set per word instead of a load per core,
+// and the idle count is kept alongside, so utilization is a single load.
+// Cores release themselves; a dispatcher claims a core with a CAS, so claims
+// from more than one thread cannot hand out the same core twice.
+class IdleCoreMask {
+public:
+    // All cores idle. Not thread-safe: call before any core thread starts.
+    void reset(int cores) {
+        count = cores;
+        wordCount = (static_cast<size_t>(cores) + 63) / 64;
+        words = std::make_unique<Word[]>(wordCount);
+        for (size_t w = 0; w < wordCount; ++w) {
+            size_t bits = std::min<size_t>(64, cores - w * 64);
+            words[w].bits.store(bits == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << bits) - 1);
+        }
+        idle.store(cores);
+    }
+
+    int size() const { return count; }
+    int idleCount() const { return idle.load(); }
+    int busyCount() const { return count - idle.load(); }
+    bool anyIdle() const { return idle.load() > 0; }
+
+    bool isIdle(int core) const {
+        return (words[core / 64].bits.load() >> (core % 64)) & 1;
+    }
+
+    // Lowest idle (or busy) core at or after from, -1 if there is none
+    int nextIdle(int from) const { return next(from, 0); }
+    int nextBusy(int from) const { return next(from, ~uint64_t{ 0 }); }
+
+    // Idle core at or after position offset of a scan that starts at core start and
+    // wraps once past the last core; offset is advanced to the core's position.
+    // -1 once the scan has covered every core.
+    int nextIdleFrom(int start, int& offset) const {
+        while (offset < count) {
+            int position = (start + offset) % count;
+            int limit = position < start ? start : count;
+            int core = nextIdle(position);
+            if (core >= 0 && core < limit) {
+                offset += core - position;
+                return core;
+            }
+            offset += limit - position;
+        }
+        return -1;
+    }
+
+    // Idle -> busy; false if the core was already claimed
+    bool claim(int core) {
+        uint64_t bit = uint64_t{ 1 } << (core % 64);
+        std::atomic<uint64_t>& bits = words[core / 64].bits;
+        uint64_t current = bits.load();
+        do {
+            if (!(current & bit)) {
+                return false;
+            }
+        } while (!bits.compare_exchange_weak(current, current & ~bit));
+        idle.fetch_sub(1);
+        return true;
+    }
+
+    // Busy -> idle, by the core itself when it gives up its process
+    void release(int core) {
+        uint64_t bit = uint64_t{ 1 } << (core % 64);
+        if (!(words[core / 64].bits.fetch_or(bit) & bit)) {
+            idle.fetch_add(1);
+        }
+    }
+
+private:
+    struct alignas(64) Word {
+        std::atomic<uint64_t> bits{ 0 };
+    };
+
+    std::unique_ptr<Word[]> words;
+    size_t wordCount = 0;
+    int count = 0;
+    std::atomic_int idle{ 0 };
+
+    // flip 0 finds set bits, ~0 finds clear ones; bits past the last core never match
+    int next(int from, uint64_t flip) const {
+        if (from < 0 || from >= count) {
+            return -1;
+        }
+        size_t w = static_cast<size_t>(from) / 64;
+        uint64_t bits = (words[w].bits.load() ^ flip) & (~uint64_t{ 0 } << (from % 64));
+        while (true) {
+            if (bits != 0) {
+                int core = static_cast<int>(w * 64 + std::countr_zero(bits));
+                return core < count ? core : -1;
+            }
+            if (++w == wordCount) {
+                return -1;
+            }
+            bits = words[w].bits.load() ^ flip;
+        }
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Binary min-heap whose entries are addressed by a small dense id (a slot index),
+// so an entry can be re-keyed or removed in O(log n) without searching for it.
+// push/pop/update/erase are O(log n), top and contains are O(1).
+// Not thread-safe: callers serialize access, as with the ready queue.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class IndexedMinHeap {
+public:
+    struct Entry {
+        Key key;
+        uint32_t id;
+        Value value;
+    };
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+    bool contains(uint32_t id) const { return id < positions.size() && positions[id] != NONE; }
+
+    const Entry& top() const { return entries.front(); }
+
+    // Inserts id, or re-keys it (and replaces its value) if it is already queued
+    void push(uint32_t id, Key key, Value value) {
+        if (contains(id)) {
+            Entry& entry = entries[positions[id]];
+            entry.value = std::move(value);
+            update(id, std::move(key));
+            return;
+        }
+        if (id >= positions.size()) {
+            positions.resize(id + 1, NONE);
+        }
+        entries.push_back(Entry{ std::move(key), id, std::move(value) });
+        positions[id] = entries.size() - 1;
+        siftUp(entries.size() - 1);
+    }
+
+    Entry pop() {
+        Entry entry = std::move(entries.front());
+        removeAt(0);
+        return entry;
+    }
+
+    bool update(uint32_t id, Key key) {
+        if (!contains(id)) {
+            return false;
+        }
+        size_t position = positions[id];
+        entries[position].key = std::move(key);
+        siftDown(siftUp(position));
+        return true;
+    }
+
+    bool erase(uint32_t id) {
+        if (!contains(id)) {
+            return false;
+        }
+        removeAt(positions[id]);
+        return true;
+    }
+
+    void clear() {
+        for (const Entry& entry : entries) {
+            positions[entry.id] = NONE;
+        }
+        entries.clear();
+    }
+
+    // Heap order, for scans that need every entry
+    typename std::vector<Entry>::const_iterator begin() const { return entries.begin(); }
+    typename std::vector<Entry>::const_iterator end() const { return entries.end(); }
+
+private:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    std::vector<Entry> entries;
+    std::vector<size_t> positions;  // by id, NONE when not queued
+    Compare less;
+
+    void place(size_t position, Entry&& entry) {
+        positions[entry.id] = position;
+        entries[position] = std::move(entry);
+    }
+
+    size_t siftUp(size_t position) {
+        Entry entry = std::move(entries[position]);
+        while (position > 0) {
+            size_t parent = (position - 1) / 2;
+            if (!less(entry.key, entries[parent].key)) {
+                break;
+            }
+            place(position, std::move(entries[parent]));
+            position = parent;
+        }
+        place(position, std::move(entry));
+        return position;
+    }
+
+    void siftDown(size_t position) {
+        Entry entry = std::move(entries[position]);
+        size_t count = entries.size();
+        while (true) {
+            size_t child = 2 * position + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && less(entries[child + 1].key, entries[child].key)) {
+                child++;
+            }
+            if (!less(entries[child].key, entry.key)) {
+                break;
+            }
+            place(position, std::move(entries[child]));
+            position = child;
+        }
+        place(position, std::move(entry));
+    }
+
+    void removeAt(size_t position) {
+        positions[entries[position].id] = NONE;
+        size_t last = entries.size() - 1;
+        if (position != last) {
+            Entry moved = std::move(entries[last]);
+            entries.pop_back();
+            place(position, std::move(moved));
+            siftDown(siftUp(position));
+        }
+        else {
+            entries.pop_back();
+        }
+    }
+};
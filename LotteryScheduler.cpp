@@ -0,0 +1,27 @@
+#include "LotteryScheduler.h"
+
+void LotteryScheduler::enqueue(Share& share) {
+    tickets.set(share.handle.index(), share.tickets);
+}
+
+bool LotteryScheduler::dequeue(ProcessHandle& handle) {
+    if (tickets.total() == 0) {
+        return false;
+    }
+    uint64_t winner = std::uniform_int_distribution<uint64_t>(0, tickets.total() - 1)(random);
+    uint32_t slot = tickets.find(winner);
+    tickets.set(slot, 0);
+    handle = shares.atSlot(slot).handle;
+    draws++;
+    return true;
+}
+
+void LotteryScheduler::remove(const Share& share) {
+    tickets.set(share.handle.index(), 0);
+}
+
+std::string LotteryScheduler::policyStats() const {
+    std::ostringstream out;
+    out << "Lottery draws: " << draws << " (" << tickets.total() << " tickets queued)" << std::endl;
+    return out.str();
+}
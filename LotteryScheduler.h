@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include "ShareScheduler.h"
+#include "FenwickTree.h"
+
+// Lottery scheduling. Each quantum goes to a ticket drawn uniformly from all
+// queued tickets, so a process wins in proportion to its tickets on average.
+// Queued tickets sit in a Fenwick tree by process table slot, so a draw is a
+// single O(log n) descent rather than a walk over the queue.
+class LotteryScheduler : public ShareScheduler {
+public:
+    // seed 0 draws from std::random_device
+    LotteryScheduler(int cores, int quantum, uint64_t seed, IMemoryAllocator& allocator)
+        : ShareScheduler(cores, quantum, allocator), random(seed != 0 ? seed : std::random_device()()) {
+    }
+
+protected:
+    void enqueue(Share& share) override;
+    bool dequeue(ProcessHandle& handle) override;
+    void remove(const Share& share) override;
+    std::string policyName() const override { return "Lottery"; }
+    std::string policyStats() const override;
+
+private:
+    FenwickTree tickets;        // queued tickets by process table slot
+    std::mt19937_64 random;
+    uint64_t draws = 0;
+};
@@ -0,0 +1,200 @@
+#include "MLFQScheduler.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+MLFQScheduler::MLFQScheduler(int cores, std::vector<int> quanta, int boostPeriod, IMemoryAllocator& allocator)
+    : Scheduler(cores, allocator), quanta(std::move(quanta)), boostPeriod(boostPeriod),
+    levels(this->quanta.size()), coreQuantum(cores, 0) {
+}
+
+std::vector<int> MLFQScheduler::parseQuanta(const std::string& spec, int levels, int baseQuantum) {
+    if (levels < 1 || levels > MAX_LEVELS) {
+        throw std::runtime_error("mlfq-levels must be between 1 and " + std::to_string(MAX_LEVELS));
+    }
+
+    std::vector<int> quanta;
+    if (spec == "auto") {
+        for (int level = 0; level < levels; ++level) {
+            quanta.push_back(std::max(1, baseQuantum) << std::min(level, 16));
+        }
+        return quanta;
+    }
+
+    std::stringstream in(spec);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        int quantum = 0;
+        try {
+            quantum = std::stoi(item);
+        }
+        catch (const std::exception&) {
+            throw std::runtime_error("Invalid mlfq-quanta entry: " + item);
+        }
+        if (quantum < 1) {
+            throw std::runtime_error("Invalid mlfq-quanta entry: " + item);
+        }
+        quanta.push_back(quantum);
+    }
+    if (static_cast<int>(quanta.size()) != levels) {
+        throw std::runtime_error("mlfq-quanta lists " + std::to_string(quanta.size()) +
+            " quanta for " + std::to_string(levels) + " levels");
+    }
+    return quanta;
+}
+
+int& MLFQScheduler::levelOf(ProcessHandle handle) {
+    return levelSlots.get(handle).level;
+}
+
+void MLFQScheduler::queueAt(ProcessHandle handle, int level) {
+    levels[level].push_back(handle);
+    nonEmptyLevels |= 1u << level;
+}
+
+bool MLFQScheduler::popHighest(ProcessHandle& handle, int& level) {
+    if (nonEmptyLevels == 0) {
+        return false;
+    }
+    level = std::countr_zero(nonEmptyLevels);
+    handle = levels[level].front();
+    levels[level].pop_front();
+    if (levels[level].empty()) {
+        nonEmptyLevels &= ~(1u << level);
+    }
+    return true;
+}
+
+void MLFQScheduler::collectArrivals() {
+    // New processes start at level 0, resumed ones go back to their level
+    while (!readyQueue.empty()) {
+        ProcessHandle handle = readyQueue.front();
+        readyQueue.pop();
+        if (resolve(handle)) {
+            queueAt(handle, levelOf(handle));
+        }
+    }
+}
+
+void MLFQScheduler::balanceLevels() {
+    if (memoryAllocator.isThrashing() && nonEmptyLevels != 0) {
+        // Suspend the last process of the lowest non-empty level
+        int lowest = std::bit_width(nonEmptyLevels) - 1;
+        ProcessHandle handle = levels[lowest].back();
+        levels[lowest].pop_back();
+        if (levels[lowest].empty()) {
+            nonEmptyLevels &= ~(1u << lowest);
+        }
+        if (resolve(handle)) {
+            suspendReadyProcess(handle);
+        }
+        return;
+    }
+
+    resumeSuspendedProcesses();
+}
+
+void MLFQScheduler::boostAll() {
+    for (size_t level = 1; level < levels.size(); ++level) {
+        for (ProcessHandle handle : levels[level]) {
+            levels[0].push_back(handle);
+        }
+        levels[level].clear();
+    }
+    nonEmptyLevels = levels[0].empty() ? 0 : 1;
+
+    // Running processes too: they requeue relative to level 0
+    for (LevelSlot& slot : levelSlots) {
+        slot.level = 0;
+    }
+}
+
+size_t MLFQScheduler::majorFaults(int pid) const {
+    return demandPaging ? demandPaging->getProcessAccounting(pid).majorFaults : 0;
+}
+
+void MLFQScheduler::schedulerThread() {
+    while (running.load() || !readyQueue.empty()) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        // Wake up for arrivals, and for freed cores while processes are queued.
+        // Suspended processes and the priority boost need a periodic wakeup as well.
+        waitForWork(lock, [this]() { return nonEmptyLevels != 0; }, boostPeriod > 0);
+
+        if (boostPeriod > 0 && tickCount.load() >= lastBoost + boostPeriod) {
+            lastBoost = tickCount.load();
+            boostAll();
+        }
+
+        collectArrivals();
+        balanceLevels();
+        collectArrivals();  // resumed processes
+
+        // Give each idle core the earliest deadline, or else the first process of the highest non-empty level
+        for (int core = idleCores.nextIdle(0); core >= 0 && (nonEmptyLevels != 0 || !realtimeQueue.empty()); core = idleCores.nextIdle(core + 1)) {
+            ProcessHandle handle;
+            int level = 0;
+            if (!popRealtime(handle)) {
+                popHighest(handle, level);
+            }
+
+            if (takeForDispatch(handle)) {
+                coreQuantum[core] = quanta[level];
+                assignCore(core, handle);
+            }
+        }
+    }
+}
+
+void MLFQScheduler::cpuCoreThread(int coreID) {
+    liveCoreThreads.fetch_add(1);
+    while (running.load() || currentProcess[coreID].valid()) {
+        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
+
+        ProcessHandle handle;
+        Process* proc = waitForProcess(coreID, lock, handle);
+        if (!proc) continue;
+        int quantum = coreQuantum[coreID];
+
+        lock.unlock();
+
+        // One instruction at a time, so the quantum ends as soon as the process blocks
+        size_t faultsBefore = majorFaults(proc->getPID());
+        int used = 0;
+        bool blocked = false;
+        while (used < quantum && !proc->isFinished() && running.load()) {
+            bool sleeps = proc->getCurrentCommandType() == ICommand::SLEEP;
+            int executed = runOnCore(handle, coreID, 1);
+            if (executed == 0) {
+                break;  // group throttled: requeued at the same level, parked at dispatch
+            }
+            used += executed;
+            if (sleeps || majorFaults(proc->getPID()) > faultsBefore) {
+                blocked = true;
+                break;
+            }
+        }
+        if (!running.load()) break; // exiting, cleanUp has emptied the queues
+
+        lock.lock();
+        if (proc->isFinished()) {
+            retireProcess(handle, coreID);
+        }
+        else {
+            // Promote after blocking, demote after using the whole quantum
+            requeueProcess(*proc, coreID, [&]() {
+                if (!queueRealtime(handle)) {
+                    int& level = levelOf(handle);
+                    if (blocked) {
+                        level = std::max(0, level - 1);
+                    }
+                    else if (used >= quantum) {
+                        level = std::min(static_cast<int>(levels.size()) - 1, level + 1);
+                    }
+                    queueAt(handle, level);
+                }
+                });
+        }
+    }
+    liveCoreThreads.fetch_sub(1);
+}
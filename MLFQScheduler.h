@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "AScheduler.h"
+
+// Multilevel feedback queue. New processes enter level 0, the highest priority,
+// and each level has its own quantum. A process that uses its whole quantum is
+// demoted one level; one that blocks first (a SLEEP, or a page read back from the
+// backing store) is promoted one level. Every boostPeriod ticks all processes go
+// back to level 0, so long jobs at the bottom are not starved.
+class MLFQScheduler : public Scheduler {
+public:
+    static constexpr int MAX_LEVELS = 32;   // one bit per level in nonEmptyLevels
+
+    MLFQScheduler(int cores, std::vector<int> quanta, int boostPeriod, IMemoryAllocator& allocator);
+
+    void schedulerThread() override;
+    void cpuCoreThread(int coreID) override;
+
+    // "auto" gives baseQuantum doubled per level, otherwise a comma-separated
+    // quantum per level, e.g. 2,4,8,16. Throws on a malformed list.
+    static std::vector<int> parseQuanta(const std::string& spec, int levels, int baseQuantum);
+
+private:
+    // Level of each live process
+    struct LevelSlot {
+        ProcessHandle handle;
+        int level = 0;
+    };
+
+    std::vector<int> quanta;                    // by level, level 0 first
+    int boostPeriod;                            // CPU ticks between boosts, 0 disables
+    uint64_t lastBoost = 0;
+
+    // Guarded by queueMutex; readyQueue takes arrivals and resumed processes
+    std::vector<std::deque<ProcessHandle>> levels;
+    uint32_t nonEmptyLevels = 0;                // bit i set while levels[i] is not empty
+    SlotTable<LevelSlot> levelSlots;
+    std::vector<int> coreQuantum;               // quantum of the process dispatched to each core
+
+    int& levelOf(ProcessHandle handle);
+    void queueAt(ProcessHandle handle, int level);
+    bool popHighest(ProcessHandle& handle, int& level);
+    void collectArrivals();
+    void balanceLevels();
+    void boostAll();
+    size_t majorFaults(int pid) const;
+};
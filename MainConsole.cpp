@@ -55,13 +55,33 @@ void MainConsole::process() {
             handleMarquee();
         }
         else if (lowerCommand == "process-smi") {
-            ProcessScheduler::getInstance().showProcessList();
+            if (commandTokens.size() == 3 && commandTokens[1] == "--sort") {
+                ProcessScheduler::getInstance().showProcessList(toLower(commandTokens[2]));
+            }
+            else {
+                ProcessScheduler::getInstance().showProcessList();
+            }
         }
         else if (lowerCommand == "vmstat") {
             ProcessScheduler::getInstance().showVMStat();
         }
+        else if (lowerCommand == "memory-footprint") {
+            ProcessScheduler::getInstance().showMemoryFootprint();
+        }
+        else if (lowerCommand == "clone") {
+            if (commandTokens.size() != 3) {
+                std::cout << "Usage: clone <process_name> <new_name>" << std::endl;
+            }
+            else {
+                ConsoleManager::getInstance().cloneScreen(commandTokens[1], commandTokens[2]);
+            }
+        }
+        else if (lowerCommand == "memory-view") {
+            bool changedOnly = commandTokens.size() > 1 && commandTokens[1] == "--diff";
+            ProcessScheduler::getInstance().showMemoryView(changedOnly);
+        }
         else {
-            std::cout << "Unknown command. Available commands: initialize, marquee, screen, scheduler-start, scheduler-stop, report-util, process-smi, vmstat, clear, exit" << std::endl;
+            std::cout << "Unknown command. Available commands: initialize, marquee, screen, scheduler-start, scheduler-stop, report-util, process-smi [--sort <column>], vmstat, memory-footprint, memory-view [--diff], clone, clear, exit" << std::endl;
         }
     }
     ConsoleManager::getInstance().clearScreen();
@@ -188,24 +208,7 @@ void MainConsole::handleScreen(std::vector<std::string> commandTokens) {
         return;
     case 4:
         if (commandTokens[1] == "-s") {
-            name = commandTokens[2]; // Use provided name instead of "empty"
-            size_t requiredMem = 0;
-            try {
-                requiredMem = std::stoull(commandTokens[3]);
-                if (!ProcessScheduler::getInstance().isValidMemorySize(requiredMem)) {
-                    std::cout << "Memory size out of range. Please enter a smaller number." << std::endl;
-                    return;
-                }
-                if (ProcessScheduler::getInstance().processExists(name)) {
-                    std::cout << "Process '" << name << "' already exists. Use screen -r " << name << " to view it." << std::endl;
-                    return;
-                }
-                ConsoleManager::getInstance().startScreen(name, requiredMem);
-            }
-            catch (const std::exception& e) {
-                std::cerr << "Invalid memory size: " << e.what() << std::endl;
-                return;
-            }
+            handleStartScreen(commandTokens);
         }
         else if (commandTokens[1] == "-s") {
             size_t requiredMem = 0;  
@@ -240,11 +243,84 @@ void MainConsole::handleScreen(std::vector<std::string> commandTokens) {
         }
         return;
     default:
+        if (commandTokens[1] == "-s") {
+            handleStartScreen(commandTokens);
+            return;
+        }
         std::cout << "Too many parameters provided. The options for 'screen' are <-r|-s|-c>." << std::endl;
 		return;
     }
 }
 
+void MainConsole::handleStartScreen(const std::vector<String>& commandTokens) {
+    String name = commandTokens[2];
+    size_t requiredMem = 0;
+    ScreenOptions options;
+    try {
+        requiredMem = std::stoull(commandTokens[3]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Invalid memory size: " << e.what() << std::endl;
+        return;
+    }
+
+    // Options come in pairs after the memory size
+    for (size_t i = 4; i < commandTokens.size(); i += 2) {
+        if (i + 1 >= commandTokens.size()) {
+            std::cout << "Missing value for " << commandTokens[i] << "." << std::endl;
+            return;
+        }
+        String option = toLower(commandTokens[i]);
+        try {
+            if (option == "--nice") {
+                options.nice = std::stoi(commandTokens[i + 1]);
+                if (options.nice < -20 || options.nice > 19) {
+                    std::cout << "Nice value must be between -20 and 19." << std::endl;
+                    return;
+                }
+            }
+            else if (option == "--deadline") {
+                long long ticks = std::stoll(commandTokens[i + 1]);
+                if (ticks < 1) {
+                    std::cout << "Deadline must be at least 1 tick." << std::endl;
+                    return;
+                }
+                options.deadlineTicks = static_cast<uint64_t>(ticks);
+            }
+            else if (option == "--tickets") {
+                long long tickets = std::stoll(commandTokens[i + 1]);
+                if (tickets < 1 || tickets > 1000000) {
+                    std::cout << "Tickets must be between 1 and 1000000." << std::endl;
+                    return;
+                }
+                options.tickets = static_cast<uint32_t>(tickets);
+            }
+            else if (option == "--group") {
+                options.group = commandTokens[i + 1];
+            }
+            else {
+                std::cout << "Unknown option " << commandTokens[i] << ". Usage: screen -s <name> <memory> "
+                    << "[--nice <n>] [--deadline <ticks>] [--tickets <n>] [--group <name>]" << std::endl;
+                return;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << commandTokens[i] << ": " << e.what() << std::endl;
+            return;
+        }
+    }
+
+    if (!ProcessScheduler::getInstance().isValidMemorySize(requiredMem)) {
+        std::cout << "Memory size out of range. Please enter a smaller number." << std::endl;
+        return;
+    }
+    if (ProcessScheduler::getInstance().processExists(name)) {
+        std::cout << "Process '" << name << "' already exists. Use screen -r " << name << " to view it." << std::endl;
+        return;
+    }
+    ConsoleManager::getInstance().startScreen(name, requiredMem, options);
+}
+
 void MainConsole::handleSchedulerTest() {
     ProcessScheduler::getInstance().start();
 }
@@ -21,6 +21,7 @@ private:
     
     void handleInitialize();
     void handleScreen(std::vector<String> commandTokens);
+    void handleStartScreen(const std::vector<String>& commandTokens);  // screen -s <name> <mem> [options]
     void handleSchedulerTest();
     void handleSchedulerStop();
     void handleReportUtil();
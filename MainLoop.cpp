@@ -1,7 +1,18 @@
 #include "ConsoleManager.h"
 #include "ProcessScheduler.h"
+#include "PagingSimulator.h"
+#include "Benchmark.h"
+#include <string>
+
+int main(int argc, char* argv[]) {
+    // Offline replay of a recorded access trace, no emulator
+    if (argc > 1 && std::string(argv[1]) == "--replay") {
+        return PagingSimulator::runFromCommandLine(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return Benchmark::runFromCommandLine(argc, argv);
+    }
 
-int main() {
     ConsoleManager::getInstance().init();
     ConsoleManager::getInstance().showMainConsole();
 
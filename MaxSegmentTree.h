@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Segment tree of values addressed by a small dense id (a block address), each
+// node holding the maximum of its range. set and the search for the lowest id
+// at or after a position whose value reaches a threshold are O(log n), so a
+// first-fit or next-fit allocator finds its run without walking the free list.
+// Not thread-safe: callers serialize access.
+class MaxSegmentTree {
+public:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    // n ids, all 0
+    void reset(size_t n) {
+        leaves = 1;
+        while (leaves < n) {
+            leaves *= 2;
+        }
+        tree.assign(2 * leaves, 0);
+    }
+
+    uint64_t get(size_t id) const { return tree[leaves + id]; }
+
+    void set(size_t id, uint64_t value) {
+        size_t i = leaves + id;
+        tree[i] = value;
+        for (i /= 2; i > 0; i /= 2) {
+            tree[i] = std::max(tree[2 * i], tree[2 * i + 1]);
+        }
+    }
+
+    // Lowest id >= from whose value is at least value (> 0), NONE if there is none
+    size_t findFirst(size_t from, uint64_t value) const {
+        if (from >= leaves) {
+            return NONE;
+        }
+        size_t i = leaves + from;
+        if (tree[i] < value) {
+            // Up until a right sibling's range holds a large enough value, then down into it
+            while (true) {
+                if (i == 1) {
+                    return NONE;
+                }
+                if (i % 2 == 0 && tree[i + 1] >= value) {
+                    i++;
+                    break;
+                }
+                i /= 2;
+            }
+            while (i < leaves) {
+                i = tree[2 * i] >= value ? 2 * i : 2 * i + 1;
+            }
+        }
+        return i - leaves;
+    }
+
+private:
+    std::vector<uint64_t> tree;     // tree[1] is the root, leaves from tree[leaves]
+    size_t leaves = 0;
+};
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <vector>
 #include <unordered_map>
+#include <map>
+#include <set>
 #include <string>
 #include <algorithm>
 #include <filesystem>
@@ -10,51 +12,132 @@
 #include <fstream>
 #include <atomic>
 #include <mutex>
+#include <cstdint>
 
 #include "Process.h"
+#include "PageTable.h"
+#include "MemoryView.h"
+#include "BackingStore.h"
+#include "SwapCache.h"
+#include "AccessTrace.h"
+#include "MaxSegmentTree.h"
 
 // Enhanced interface with demand paging support
 class IMemoryAllocator {
 public:
     virtual void* allocate(std::shared_ptr<Process> process) = 0;
     virtual void deallocate(std::shared_ptr<Process> process) = 0;
-    virtual std::string visualizeMemory() = 0;
+    // Run-length encoded view; changedOnly lists only what changed since the previous view
+    virtual std::string visualizeMemory(bool changedOnly = false) = 0;
     virtual ~IMemoryAllocator() = default;
+
+    // Medium-term scheduling hooks; only allocators that track working sets override these
+    virtual bool isThrashing() const { return false; }
+    virtual void suspendProcess(std::shared_ptr<Process> /*process*/) {}
+    virtual bool canResume(std::shared_ptr<Process> /*process*/) const { return true; }
+    virtual void resumeProcess(std::shared_ptr<Process> /*process*/) {}
+
+    // Give child a copy of parent's memory; allocators without sharing just allocate it
+    virtual bool cloneProcess(std::shared_ptr<Process> /*parent*/, std::shared_ptr<Process> child) {
+        return allocate(child) != nullptr;
+    }
 };
 
-// Page table entry structure
-struct PageTableEntry {
-    bool present = false;           // Is page in physical memory?
-    bool dirty = false;             // Has page been modified?
-    bool referenced = false;        // Has page been accessed recently?
-    size_t frameNumber = 0;         // Physical frame number if present
-    size_t backingStoreOffset = 0;  // Offset in backing store if swapped out
+// Physical frame table kept as parallel arrays (struct-of-arrays) so the LRU
+// scan only streams through the access stamps.
+struct FrameTable {
+    static constexpr uint32_t NO_OWNER = UINT32_MAX;
 
-    PageTableEntry() = default;
+    std::vector<uint32_t> owner;        // Owning process ID, NO_OWNER when free
+    std::vector<uint32_t> pageNumber;   // Page number within the owning process
+    std::vector<uint64_t> lastAccessed; // Logical access clock stamp for LRU
+
+    void resize(size_t n) {
+        owner.assign(n, NO_OWNER);
+        pageNumber.assign(n, 0);
+        lastAccessed.assign(n, 0);
+    }
+    bool isOccupied(size_t frame) const { return owner[frame] != NO_OWNER; }
+    // Owners are written through atomic_ref so visualizeMemory can snapshot them without the allocator lock
+    void assign(size_t frame, uint32_t processId, uint32_t page) {
+        std::atomic_ref<uint32_t>(owner[frame]).store(processId, std::memory_order_relaxed);
+        pageNumber[frame] = page;
+    }
+    void release(size_t frame) {
+        std::atomic_ref<uint32_t>(owner[frame]).store(NO_OWNER, std::memory_order_relaxed);
+        pageNumber[frame] = 0;
+    }
+    uint32_t loadOwner(size_t frame) const {
+        return std::atomic_ref<uint32_t>(const_cast<uint32_t&>(owner[frame])).load(std::memory_order_relaxed);
+    }
+    size_t bytesPerFrame() const { return sizeof(uint32_t) * 2 + sizeof(uint64_t); }
 };
 
-// Frame information for physical memory management
-struct FrameInfo {
-    bool occupied = false;
-    size_t processId = 0;
-    size_t pageNumber = 0;
-    std::chrono::steady_clock::time_point lastAccessed;
+// Per-process paging activity, indexed by PID
+struct ProcessPagingStats {
+    size_t windowAccesses = 0;      // Accesses in the current working-set window
+    size_t windowFaults = 0;        // Page faults in the current working-set window
+    size_t windowEvictedRefs = 0;   // Referenced pages evicted during the current window
+    size_t workingSet = 0;          // Distinct pages referenced during the last window
+    double faultFrequency = 0.0;    // Faults per access during the last window
+    bool suspended = false;         // Swapped out by the medium-term scheduler
+    size_t lastSwapSlot = SIZE_MAX; // Slot of this process's last swap-out, for clustering
+};
 
-    FrameInfo() : lastAccessed(std::chrono::steady_clock::now()) {}
+// Per-process memory accounting, indexed by PID; the counters outlive the process
+struct ProcessMemoryAccounting {
+    size_t residentPages = 0;       // Pages mapped to a frame (shared frames count for every mapper)
+    size_t swappedPages = 0;        // Pages in the swap cache or the backing store
+    size_t minorFaults = 0;         // Faults served without reading the backing store
+    size_t majorFaults = 0;         // Faults that read the backing store
+    size_t bytesWritten = 0;        // Bytes written to the backing store for this process
+    size_t peakResident = 0;        // Highest residentPages seen
 };
 
-class DemandPagingAllocator : public IMemoryAllocator {
+struct SwapCacheStats {
+    size_t entries = 0;
+    size_t storedBytes = 0;
+    size_t budget = 0;
+    double compressionRatio = 0.0;  // original / compressed bytes over all stores
+    size_t stores = 0;              // evictions absorbed without a file write
+    size_t hits = 0;                // faults served without a file read
+    size_t writebacks = 0;          // entries pushed out to the file
+};
+
+// A (process, page) mapping of a frame shared copy-on-write
+struct FrameMapping {
+    uint32_t processId;
+    uint32_t pageNumber;
+};
+
+class DemandPagingAllocator final : public IMemoryAllocator {
 public:
     DemandPagingAllocator(size_t maxMemorySize, size_t frameSize, size_t maxFrames, const std::string& backingStoreFile = "backing_store.dat");
     ~DemandPagingAllocator();
 
     void* allocate(std::shared_ptr<Process> process) override;
     void deallocate(std::shared_ptr<Process> process) override;
-    std::string visualizeMemory() override;
+    std::string visualizeMemory(bool changedOnly = false) override;
+
+    // Page table / frame table metadata size, packed layout vs. the old one
+    std::string footprintReport() const;
 
     // Page access simulation (called when process tries to access memory)
     bool accessPage(size_t processId, size_t pageNumber, bool isWrite = false);
 
+    // Working-set tracking and thrashing control
+    bool isThrashing() const override { return thrashing.load(); }
+    void suspendProcess(std::shared_ptr<Process> process) override;
+    bool canResume(std::shared_ptr<Process> process) const override;
+    void resumeProcess(std::shared_ptr<Process> process) override;
+    bool cloneProcess(std::shared_ptr<Process> parent, std::shared_ptr<Process> child) override;
+    void setWorkingSetWindow(size_t accesses) { workingSetWindow = std::max(size_t{ 1 }, accesses); }
+    void setThrashingFaultRate(double rate) { thrashingFaultRate = rate; }
+    ProcessPagingStats getProcessStats(size_t processId) const;
+    ProcessMemoryAccounting getProcessAccounting(size_t processId) const;
+    size_t getTotalWorkingSet() const { return totalWorkingSet.load(); }
+    double getFaultRate() const { return faultRate.load(); }
+
     // Statistics for vmstat
     size_t getUsedFrames() const { return usedFrames.load(); }
     size_t getTotalFrames() const { return maxFrames; }
@@ -63,6 +146,18 @@ public:
     size_t getNumPagedOut() const { return numPagedOut.load(); }
     size_t getNumPageFaults() const { return numPageFaults.load(); }
     size_t getBackingStoreSize() const { return backingStoreSize.load(); }
+    size_t getBackingStoreFileSize() const;
+    void setReadaheadWindow(size_t pages) { readaheadWindow = pages; }
+    size_t getReadaheadPages() const { return numReadaheadPages.load(); }
+    size_t getReadaheadHits() const { return numReadaheadHits.load(); }
+    void setSwapCacheBudget(size_t bytes);
+    SwapCacheStats getSwapCacheStats() const;
+    size_t getZeroPageMaps() const { return numZeroPageMaps.load(); }
+    size_t getCowFaults() const { return numCowFaults.load(); }
+    size_t getBackingStoreBytesPunched() const;
+    // Records every accessPage call to a binary trace for offline replay
+    bool startTrace(const std::string& fileName);
+    size_t getTracedAccesses() const;
 
 private:
     size_t maxMemorySize;
@@ -71,16 +166,27 @@ private:
     std::string backingStoreFile;
 
     // Physical memory frames
-    std::vector<FrameInfo> frames;
+    FrameTable frames;
     std::queue<size_t> freeFrames;
+    // Mappings of shared frames besides the owner in the frame table
+    std::unordered_map<size_t, std::vector<FrameMapping>> sharedMappers;
+    uint64_t accessClock = 0;
 
-    // Process page tables
-    std::unordered_map<size_t, std::vector<PageTableEntry>> processPageTables;
+    // Page table directory, indexed by PID
+    std::vector<PageTable> pageDirectory;
+    std::vector<ProcessPagingStats> processStats;
+    std::vector<ProcessMemoryAccounting> accounting;
+    void addResident(size_t processId);
+    PageTableEntry* findEntry(size_t processId, size_t pageNumber);
 
     // Backing store management
-    std::fstream backingStore;
-    std::queue<size_t> freeBackingStoreSlots;
-    size_t nextBackingStoreOffset;
+    BackingStore backingStore;
+    CompressedSwapCache swapCache;
+    size_t numSwapCacheStores = 0;
+    size_t numSwapCacheHits = 0;
+    size_t numSwapCacheWritebacks = 0;
+
+    std::unique_ptr<AccessTraceWriter> trace;
 
     // Statistics (thread-safe)
     mutable std::atomic<size_t> usedFrames{ 0 };
@@ -88,70 +194,149 @@ private:
     mutable std::atomic<size_t> numPagedOut{ 0 };
     mutable std::atomic<size_t> numPageFaults{ 0 };
     mutable std::atomic<size_t> backingStoreSize{ 0 };
+    mutable std::atomic<size_t> numReadaheadPages{ 0 };
+    mutable std::atomic<size_t> numReadaheadHits{ 0 };
+    mutable std::atomic<size_t> numZeroPageMaps{ 0 };
+    mutable std::atomic<size_t> numCowFaults{ 0 };
+
+    // Swapped neighbours read in together with a faulting page
+    size_t readaheadWindow = 8;
+    size_t recentReadahead = 0;         // decaying counts that gate reclaiming frames for readahead
+    size_t recentReadaheadHits = 0;
+
+    // Working-set window (measured in page accesses)
+    size_t workingSetWindow = 1000;
+    double thrashingFaultRate = 0.5;
+    size_t windowAccesses = 0;
+    size_t windowFaults = 0;
+    std::atomic<size_t> totalWorkingSet{ 0 };
+    std::atomic<double> faultRate{ 0.0 };
+    std::atomic_bool thrashing{ false };
 
     // Thread safety
     mutable std::mutex allocatorMutex;
+    MemoryView view;
 
     // Helper methods
-    size_t findVictimFrame();           // LRU page replacement
+    void closeWorkingSetWindow();       // Recompute working sets and the thrashing flag
+    size_t findVictimFrame(size_t keepFrame = SIZE_MAX); // LRU page replacement
+    bool acquireFrame(size_t& frameNumber, size_t keepFrame = SIZE_MAX); // Free frame or evicted victim
     bool swapOut(size_t frameNumber);   // Swap page to backing store
+    // Saving one mapping's contents: storePage writes them to the swap cache or file and
+    // changes nothing else, so discardPage can take them back; commitPage then points the
+    // entry at the copy. writeOutPage does both.
+    struct PageCopy {
+        size_t slot = 0;
+        bool swapped = false;
+        bool compressed = false;
+    };
+    bool writeOutPage(size_t processId, size_t pageNumber, PageTableEntry& entry);
+    bool storePage(size_t processId, size_t pageNumber, const PageTableEntry& entry, PageCopy& copy);
+    void discardPage(size_t processId, size_t pageNumber, const PageCopy& copy);
+    void commitPage(size_t processId, PageTableEntry& entry, const PageCopy& copy);
+    void detachMapping(size_t frameNumber, size_t processId, size_t pageNumber);
+    void releasePages(size_t processId);    // Frames, cache entries and swap slots of one process
+    bool breakCopyOnWrite(size_t processId, size_t pageNumber, PageTableEntry& entry);
     bool swapIn(size_t processId, size_t pageNumber, size_t frameNumber); // Swap page from backing store
-    void initializeBackingStore();
-    size_t allocateBackingStoreSlot();
-    void deallocateBackingStoreSlot(size_t offset);
+    size_t chooseSwapSlot(size_t processId, size_t pageNumber);
+    void writeBackSwapCache();          // Move the oldest cache entries to the file until under budget
+    void fillPageData(size_t processId, size_t pageNumber, char* data) const;
 };
 
-// Keep existing allocators for backward compatibility
+// Contiguous allocator: each process gets one run of blocks placed by a
+// buddy system or a first/best/next-fit policy over segregated free lists
 class FlatMemoryAllocator : public IMemoryAllocator {
 public:
-    FlatMemoryAllocator(size_t maximumSize, size_t memPerProcSize);
-    ~FlatMemoryAllocator() { memory.clear(); }
+    enum class Policy { BUDDY, FIRST_FIT, BEST_FIT, NEXT_FIT };
+
+    FlatMemoryAllocator(size_t maximumSize, size_t blockSize, Policy policy = Policy::FIRST_FIT);
 
     void* allocate(std::shared_ptr<Process> process) override;
     void deallocate(std::shared_ptr<Process> process) override;
-    std::string visualizeMemory() override;
-    void setCurrentPID(int pid) { currentPID = pid; }
+    std::string visualizeMemory(bool changedOnly = false) override;
+
+    static bool parsePolicy(const std::string& name, Policy& policy);
+    static std::string policyName(Policy policy);
+    Policy getPolicy() const { return policy; }
+
+    // Statistics for vmstat
+    size_t getTotalSize() const { return totalBlocks * blockSize; }
+    size_t getAllocatedSize() const;
+    size_t getFreeSize() const;
+    size_t getLargestFreeBlock() const;
+    size_t getNumFreeBlocks() const;
+    size_t getNumAllocations() const;
+    size_t getInternalFragmentation() const;   // Bytes lost to block/buddy rounding
+    double getExternalFragmentation() const;   // 1 - largest free block / total free
 
 private:
-    size_t maxSize = 0;
-    size_t allocatedSize = 0;
-    size_t memPerProc = 4096;
-    int currentPID = -1;
-
-    std::vector<char> memory;
-    std::unordered_map<size_t, bool> allocationMap;
-    std::unordered_map<size_t, int> processMap;
-
-    void initializeMemory();
-    bool canAllocateAt(size_t index, size_t size) const;
-    void allocateAt(size_t index, size_t size);
-    void deallocateAt(size_t index);
+    struct Allocation {
+        size_t start = 0;           // First block
+        size_t blocks = 0;          // Blocks reserved (power of two for buddy)
+        size_t requested = 0;       // Bytes the process asked for
+    };
+
+    size_t blockSize;
+    size_t totalBlocks;
+    Policy policy;
+    mutable std::mutex allocatorMutex;
+    MemoryView view;
+
+    std::unordered_map<size_t, Allocation> allocations;    // PID -> allocation
+    size_t freeBlocks = 0;
+
+    // Fit policies: free runs indexed by address (coalescing), by size (best fit)
+    // and by address with the longest run of each range (first and next fit)
+    std::map<size_t, size_t> freeByAddress;                 // start -> length
+    std::set<std::pair<size_t, size_t>> freeBySize;         // (length, start)
+    MaxSegmentTree runLengths;                              // start -> length, 0 where no run starts
+    size_t nextFitCursor = 0;
+
+    // Buddy system: free block starts per order (block length = 1 << order)
+    std::vector<std::set<size_t>> buddyFreeLists;
+
+    static size_t sizeClassOf(size_t length);
+    void insertFreeRun(size_t start, size_t length);
+    void eraseFreeRun(size_t start, size_t length);
+    bool findFit(size_t length, size_t& start);
+    size_t allocateRun(size_t length);                      // Returns totalBlocks on failure
+    void freeRun(size_t start, size_t length);
+    size_t allocateBuddy(size_t order);                     // Returns totalBlocks on failure
+    void freeBuddy(size_t start, size_t order);
 };
 
+// Fixed-size frame allocator: every page of a process is backed by a frame at allocation time
 class PagingAllocator : public IMemoryAllocator {
 public:
     PagingAllocator(size_t maxMemorySize, size_t numFrames);
 
     void* allocate(std::shared_ptr<Process> process) override;
     void deallocate(std::shared_ptr<Process> process) override;
-    std::string visualizeMemory() override;
+    std::string visualizeMemory(bool changedOnly = false) override;
 
     // Methods for vmstat
-    size_t getUsedFrames() const { return frameMap.size(); }
+    size_t getUsedFrames() const { return numFrames - freeFrameCount.load(); }
     size_t getTotalFrames() const { return numFrames; }
-    size_t getFreeFrames() const { return freeFrameList.size(); }
+    size_t getFreeFrames() const { return freeFrameCount.load(); }
     size_t getNumPagedIn() const { return numPagedIn; }
     size_t getNumPagedOut() const { return numPagedOut; }
 
 private:
+    static constexpr uint32_t NO_OWNER = UINT32_MAX;
+
     size_t maxMemorySize;
     size_t numFrames;
-    std::unordered_map<size_t, size_t> frameMap;
-    std::vector<size_t> freeFrameList;
+    std::vector<uint64_t> freeBitmap;                               // bit set = frame free
+    std::vector<uint32_t> frameOwner;                               // PID per frame
+    std::unordered_map<size_t, std::vector<size_t>> processFrames;  // PID -> frames it holds
+    mutable std::mutex allocatorMutex;
+    MemoryView view;
 
+    std::atomic<size_t> freeFrameCount{ 0 };
     mutable std::atomic<size_t> numPagedIn{ 0 };
     mutable std::atomic<size_t> numPagedOut{ 0 };
 
-    size_t allocateFrames(size_t numFrames, size_t processID);
-    void deallocateFrames(size_t numFrames, size_t frameIndex);
-};
\ No newline at end of file
+    size_t findFreeRun(size_t length) const;                        // numFrames if no run is long enough
+    void allocateFrames(size_t numFrames, size_t processID, std::vector<size_t>& frames);
+    void deallocateFrames(const std::vector<size_t>& frames);
+};
@@ -0,0 +1,49 @@
+#include "MemoryView.h"
+#include <sstream>
+
+std::string MemoryView::ownerName(uint32_t owner) {
+    return owner == FREE ? "Free" : "Process " + std::to_string(owner);
+}
+
+std::string MemoryView::render(std::vector<uint32_t> owners, const std::string& unitName, bool changedOnly) {
+    std::lock_guard<std::mutex> lock(viewMutex);
+    std::ostringstream oss;
+
+    if (!changedOnly) {
+        size_t runStart = 0;
+        for (size_t i = 1; i <= owners.size(); ++i) {
+            if (i == owners.size() || owners[i] != owners[runStart]) {
+                oss << unitName << "s " << runStart << "-" << i - 1 << " (" << i - runStart << "): "
+                    << ownerName(owners[runStart]) << "\n";
+                runStart = i;
+            }
+        }
+    }
+    else {
+        if (lastSnapshot.size() != owners.size()) {
+            lastSnapshot.assign(owners.size(), FREE);
+        }
+
+        // Runs of units whose (old owner, new owner) pair is the same
+        size_t changed = 0;
+        size_t i = 0;
+        while (i < owners.size()) {
+            if (owners[i] == lastSnapshot[i]) {
+                i++;
+                continue;
+            }
+            size_t runStart = i;
+            while (i < owners.size() && owners[i] != lastSnapshot[i]
+                && owners[i] == owners[runStart] && lastSnapshot[i] == lastSnapshot[runStart]) {
+                i++;
+            }
+            oss << unitName << "s " << runStart << "-" << i - 1 << " (" << i - runStart << "): "
+                << ownerName(lastSnapshot[runStart]) << " -> " << ownerName(owners[runStart]) << "\n";
+            changed += i - runStart;
+        }
+        oss << changed << " " << unitName << "(s) changed since last view\n";
+    }
+
+    lastSnapshot = std::move(owners);
+    return oss.str();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Run-length encoded rendering of a frame (or block) -> owner map.
+// Contiguous frames with the same owner are printed as one line, and the
+// changed-only mode prints just the frames whose owner differs from the
+// previous render.
+class MemoryView {
+public:
+    static constexpr uint32_t FREE = UINT32_MAX;
+
+    // owners[i] is the PID holding unit i, or FREE
+    std::string render(std::vector<uint32_t> owners, const std::string& unitName, bool changedOnly);
+
+private:
+    std::mutex viewMutex;                   // guards lastSnapshot only, never the allocator
+    std::vector<uint32_t> lastSnapshot;
+
+    static std::string ownerName(uint32_t owner);
+};
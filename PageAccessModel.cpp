@@ -0,0 +1,121 @@
+#include "PageAccessModel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+    // rand() is shared between the core threads; each core gets its own engine
+    std::mt19937_64& engine() {
+        thread_local std::mt19937_64 rng(std::random_device{}());
+        return rng;
+    }
+
+    double uniform01() {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(engine());
+    }
+
+    size_t uniformBelow(size_t n) {
+        return std::uniform_int_distribution<size_t>(0, n - 1)(engine());
+    }
+
+    // Helpers for the Zipf sampler, stable near zero
+    double log1pOverX(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    double expm1OverX(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+    }
+}
+
+bool PageAccessModel::parseKind(const std::string& name, Kind& kind) {
+    if (name == "uniform") kind = Kind::UNIFORM;
+    else if (name == "sequential") kind = Kind::SEQUENTIAL;
+    else if (name == "zipf") kind = Kind::ZIPF;
+    else if (name == "phased") kind = Kind::PHASED;
+    else if (name == "stride") kind = Kind::STRIDE;
+    else return false;
+    return true;
+}
+
+std::string PageAccessModel::kindName(Kind kind) {
+    switch (kind) {
+    case Kind::UNIFORM: return "uniform";
+    case Kind::SEQUENTIAL: return "sequential";
+    case Kind::ZIPF: return "zipf";
+    case Kind::PHASED: return "phased";
+    case Kind::STRIDE: return "stride";
+    }
+    return "unknown";
+}
+
+size_t PageAccessModel::nextPage(PageAccessCursor& cursor, size_t numPages, bool& isWrite) const {
+    isWrite = uniform01() < writeRatio;
+
+    size_t page = 0;
+    switch (kind) {
+    case Kind::UNIFORM:
+        page = uniformBelow(numPages);
+        break;
+    case Kind::SEQUENTIAL:
+        page = cursor.position % numPages;
+        cursor.position = page + 1;
+        break;
+    case Kind::ZIPF:
+        page = zipfPage(numPages);
+        break;
+    case Kind::PHASED: {
+        size_t setPages = phasePages > 0 ? std::min(phasePages, numPages) : std::max(numPages / 4, size_t{ 1 });
+        if (cursor.phaseRemaining == 0) {
+            cursor.phaseBase = uniformBelow(numPages);
+            cursor.phaseRemaining = phaseLength;
+        }
+        cursor.phaseRemaining--;
+        page = (cursor.phaseBase + uniformBelow(setPages)) % numPages;
+        break;
+    }
+    case Kind::STRIDE:
+        // Row-major array walked column-major: page, page + stride, ... then the next column
+        if (cursor.position >= numPages) {
+            cursor.column = (cursor.column + 1) % std::min(stride, numPages);
+            cursor.position = cursor.column;
+        }
+        page = cursor.position;
+        cursor.position += stride;
+        break;
+    }
+    return page;
+}
+
+// Rejection-inversion sampling (Hormann & Derflinger): O(1) per sample
+// without a per-size table. Rank 1 maps to page 0.
+size_t PageAccessModel::zipfPage(size_t numPages) const {
+    if (numPages == 1) {
+        return 0;
+    }
+
+    const double s = zipfExponent;
+    auto h = [s](double x) { return std::exp(-s * std::log(x)); };
+    auto hIntegral = [s](double x) {
+        double logX = std::log(x);
+        return expm1OverX((1.0 - s) * logX) * logX;
+    };
+    auto hIntegralInverse = [s](double x) {
+        double t = std::max(x * (1.0 - s), -1.0);
+        return std::exp(log1pOverX(t) * x);
+    };
+
+    const double n = static_cast<double>(numPages);
+    const double hIntegralX1 = hIntegral(1.5) - 1.0;
+    const double hIntegralN = hIntegral(n + 0.5);
+    const double squeeze = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+
+    while (true) {
+        double u = hIntegralN + uniform01() * (hIntegralX1 - hIntegralN);
+        double x = hIntegralInverse(u);
+        double k = std::clamp(std::floor(x + 0.5), 1.0, n);
+        if (k - x <= squeeze || u >= hIntegral(k + 0.5) - h(k)) {
+            return static_cast<size_t>(k) - 1;
+        }
+    }
+}
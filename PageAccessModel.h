@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Per-process position within its access pattern
+struct PageAccessCursor {
+    size_t position = 0;
+    size_t column = 0;          // Stride: which column of the loop nest
+    size_t phaseBase = 0;       // Phased: first page of the current working set
+    size_t phaseRemaining = 0;  // Phased: accesses left before the working set moves
+};
+
+// Generates the page numbers the cores touch while executing instructions.
+//   uniform    - every page equally likely
+//   sequential - scan through the pages, wrapping around
+//   zipf       - page k is hit with probability ~ 1 / k^s (small hot set)
+//   phased     - uniform within a working set that jumps every phase-length accesses
+//   stride     - loop nest walking the pages column by column, access-stride apart
+class PageAccessModel {
+public:
+    enum class Kind { UNIFORM, SEQUENTIAL, ZIPF, PHASED, STRIDE };
+
+    static bool parseKind(const std::string& name, Kind& kind);
+    static std::string kindName(Kind kind);
+
+    void setKind(Kind k) { kind = k; }
+    void setZipfExponent(double s) { zipfExponent = s > 0.0 ? s : 1.0; }
+    void setPhaseLength(size_t accesses) { phaseLength = accesses > 0 ? accesses : 1; }
+    void setPhasePages(size_t pages) { phasePages = pages; }
+    void setStride(size_t pages) { stride = pages > 0 ? pages : 1; }
+    void setWriteRatio(double ratio) { writeRatio = ratio; }
+    Kind getKind() const { return kind; }
+
+    // Next page for a process with numPages pages (> 0); thread-safe
+    size_t nextPage(PageAccessCursor& cursor, size_t numPages, bool& isWrite) const;
+
+private:
+    Kind kind = Kind::UNIFORM;
+    double zipfExponent = 1.0;
+    size_t phaseLength = 500;
+    size_t phasePages = 0;      // 0 = a quarter of the process
+    size_t stride = 8;
+    double writeRatio = 0.25;
+
+    size_t zipfPage(size_t numPages) const;
+};
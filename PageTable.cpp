@@ -0,0 +1,70 @@
+#include "PageTable.h"
+#include <algorithm>
+
+PageTable::PageTable(size_t numPages) : numPages(numPages) {
+    size_t numLeaves = (numPages + LEAF_SIZE - 1) / LEAF_SIZE;
+    top.resize((numLeaves + MIDDLE_SIZE - 1) / MIDDLE_SIZE);
+}
+
+size_t PageTable::leafLength(size_t leafIndex) const {
+    // The last leaf is trimmed so small processes don't pay for a full leaf
+    size_t base = leafIndex << LEAF_BITS;
+    return std::min(LEAF_SIZE, numPages - base);
+}
+
+PageTableEntry* PageTable::find(size_t pageNumber) {
+    if (pageNumber >= numPages) {
+        return nullptr;
+    }
+
+    size_t leafIndex = pageNumber >> LEAF_BITS;
+    Middle* middle = top[leafIndex >> MIDDLE_BITS].get();
+    if (!middle) {
+        return nullptr;
+    }
+
+    PageTableEntry* leaf = middle->leaves[leafIndex & (MIDDLE_SIZE - 1)].get();
+    if (!leaf) {
+        return nullptr;
+    }
+    return &leaf[pageNumber & (LEAF_SIZE - 1)];
+}
+
+const PageTableEntry* PageTable::find(size_t pageNumber) const {
+    return const_cast<PageTable*>(this)->find(pageNumber);
+}
+
+PageTableEntry* PageTable::touch(size_t pageNumber) {
+    if (pageNumber >= numPages) {
+        return nullptr;
+    }
+
+    size_t leafIndex = pageNumber >> LEAF_BITS;
+    size_t topIndex = leafIndex >> MIDDLE_BITS;
+
+    std::unique_ptr<Middle>& middle = top[topIndex];
+    if (!middle) {
+        size_t totalLeaves = (numPages + LEAF_SIZE - 1) / LEAF_SIZE;
+        middle = std::make_unique<Middle>();
+        middle->numLeaves = std::min(MIDDLE_SIZE, totalLeaves - (topIndex << MIDDLE_BITS));
+        middle->leaves = std::make_unique<std::unique_ptr<PageTableEntry[]>[]>(middle->numLeaves);
+        allocatedMiddles++;
+        allocatedLeafSlots += middle->numLeaves;
+    }
+
+    std::unique_ptr<PageTableEntry[]>& leaf = middle->leaves[leafIndex & (MIDDLE_SIZE - 1)];
+    if (!leaf) {
+        size_t length = leafLength(leafIndex);
+        leaf = std::make_unique<PageTableEntry[]>(length);
+        allocatedEntries += length;
+    }
+    return &leaf[pageNumber & (LEAF_SIZE - 1)];
+}
+
+size_t PageTable::footprintBytes() const {
+    return sizeof(PageTable)
+        + top.capacity() * sizeof(std::unique_ptr<Middle>)
+        + allocatedMiddles * sizeof(Middle)
+        + allocatedLeafSlots * sizeof(std::unique_ptr<PageTableEntry[]>)
+        + allocatedEntries * sizeof(PageTableEntry);
+}
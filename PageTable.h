@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Page table entry packed into a single 64-bit word.
+// Bits 0-7 hold the flags, bits 8-63 hold the frame number while the page is
+// present, or the backing store slot while it is swapped out (SWAPPED set).
+struct PageTableEntry {
+    static constexpr uint64_t PRESENT = 1ull << 0;      // Is page in physical memory?
+    static constexpr uint64_t DIRTY = 1ull << 1;        // Has page been modified?
+    static constexpr uint64_t REFERENCED = 1ull << 2;   // Has page been accessed recently?
+    static constexpr uint64_t SWAPPED = 1ull << 3;      // Does the page live in a backing store slot?
+    static constexpr uint64_t READAHEAD = 1ull << 4;    // Brought in by readahead, not yet accessed
+    static constexpr uint64_t COMPRESSED = 1ull << 5;   // Held in the compressed swap cache
+    static constexpr uint64_t ZERO = 1ull << 6;         // Mapped read-only to the shared zero page
+    static constexpr uint64_t COPY_ON_WRITE = 1ull << 7; // Frame may be shared, copy before writing
+    static constexpr unsigned NUMBER_SHIFT = 8;
+
+    uint64_t bits = 0;
+
+    bool isPresent() const { return bits & PRESENT; }
+    bool isDirty() const { return bits & DIRTY; }
+    bool isReferenced() const { return bits & REFERENCED; }
+    bool isSwapped() const { return bits & SWAPPED; }
+    bool isCompressed() const { return bits & COMPRESSED; }
+    bool isZero() const { return bits & ZERO; }
+    bool isCopyOnWrite() const { return bits & COPY_ON_WRITE; }
+    void setFlag(uint64_t flag, bool on) { bits = on ? (bits | flag) : (bits & ~flag); }
+
+    size_t getFrameNumber() const { return static_cast<size_t>(bits >> NUMBER_SHIFT); }
+    size_t getSwapSlot() const { return static_cast<size_t>(bits >> NUMBER_SHIFT); }
+    void setNumber(size_t number) { bits = (bits & ((1ull << NUMBER_SHIFT) - 1)) | (static_cast<uint64_t>(number) << NUMBER_SHIFT); }
+};
+static_assert(sizeof(PageTableEntry) == sizeof(uint64_t), "PageTableEntry must stay packed");
+
+// Three-level radix page table (top -> middle -> leaf).
+// Middle and leaf levels are only allocated when a page inside them is first
+// touched, so a large, sparsely used address space costs almost nothing.
+class PageTable {
+public:
+    static constexpr unsigned LEAF_BITS = 9;    // 512 entries per leaf
+    static constexpr unsigned MIDDLE_BITS = 9;  // 512 leaves per middle node
+    static constexpr size_t LEAF_SIZE = size_t{ 1 } << LEAF_BITS;
+    static constexpr size_t MIDDLE_SIZE = size_t{ 1 } << MIDDLE_BITS;
+
+    PageTable() = default;
+    explicit PageTable(size_t numPages);
+
+    size_t size() const { return numPages; }
+    bool empty() const { return numPages == 0; }
+
+    // Returns nullptr if the page is out of range or was never touched
+    PageTableEntry* find(size_t pageNumber);
+    const PageTableEntry* find(size_t pageNumber) const;
+
+    // Returns the entry, allocating the levels above it on first touch
+    PageTableEntry* touch(size_t pageNumber);
+
+    // Visit every entry in an allocated leaf as fn(pageNumber, entry)
+    template <typename Fn>
+    void forEach(Fn fn);
+    template <typename Fn>
+    void forEach(Fn fn) const;
+
+    size_t getAllocatedEntries() const { return allocatedEntries; }
+    size_t footprintBytes() const;
+
+private:
+    struct Middle {
+        std::unique_ptr<std::unique_ptr<PageTableEntry[]>[]> leaves;
+        size_t numLeaves = 0;
+    };
+
+    size_t numPages = 0;
+    size_t allocatedEntries = 0;
+    size_t allocatedMiddles = 0;
+    size_t allocatedLeafSlots = 0;
+    std::vector<std::unique_ptr<Middle>> top;
+
+    size_t leafLength(size_t leafIndex) const;
+};
+
+template <typename Fn>
+void PageTable::forEach(Fn fn) {
+    for (size_t t = 0; t < top.size(); ++t) {
+        if (!top[t]) continue;
+        for (size_t m = 0; m < top[t]->numLeaves; ++m) {
+            PageTableEntry* leaf = top[t]->leaves[m].get();
+            if (!leaf) continue;
+            size_t leafIndex = (t << MIDDLE_BITS) + m;
+            size_t base = leafIndex << LEAF_BITS;
+            for (size_t i = 0; i < leafLength(leafIndex); ++i) {
+                fn(base + i, leaf[i]);
+            }
+        }
+    }
+}
+
+template <typename Fn>
+void PageTable::forEach(Fn fn) const {
+    const_cast<PageTable*>(this)->forEach([&fn](size_t pageNumber, const PageTableEntry& entry) {
+        fn(pageNumber, entry);
+    });
+}
@@ -1,86 +1,140 @@
 #include "MemoryAllocator.h"
+#include <bit>
 
-PagingAllocator::PagingAllocator(size_t maxMemorySize, size_t numFrames) 
+PagingAllocator::PagingAllocator(size_t maxMemorySize, size_t numFrames)
 	: maxMemorySize(maxMemorySize), numFrames(numFrames) {
-	// initialize free frame list
-	for (size_t i = 0; i < numFrames; ++i) {
-		freeFrameList.push_back(i);
+	// initialize free frame bitmap (bits past the last frame stay clear)
+	freeBitmap.assign((numFrames + 63) / 64, ~uint64_t{ 0 });
+	if (numFrames % 64 != 0) {
+		freeBitmap.back() = (uint64_t{ 1 } << (numFrames % 64)) - 1;
 	}
+	frameOwner.assign(numFrames, NO_OWNER);
+	freeFrameCount = numFrames;
 }
 
 void* PagingAllocator::allocate(std::shared_ptr<Process> process) {
+	std::lock_guard<std::mutex> lock(allocatorMutex);
+
 	size_t processID = process->getPID();
-	size_t requiredFrames = process->getNumPages();
+	size_t requiredFrames = std::max(process->getNumPages(), size_t{ 1 });
+
+	auto existing = processFrames.find(processID);
+	if (existing != processFrames.end()) {
+		return reinterpret_cast<void*>(existing->second.front() + 1);
+	}
 
-	if (requiredFrames > freeFrameList.size()) {
-		std::cerr << "Memory allocation failed. Not enough free frames.\n";
-		return nullptr;
+	if (requiredFrames > freeFrameCount.load()) {
+		return nullptr; // Not enough free frames, scheduler retries later
 	}
 
 	// Allocate frames for the process
-	size_t frameIndex = allocateFrames(requiredFrames, processID);
+	std::vector<size_t>& frames = processFrames[processID];
+	frames.reserve(requiredFrames);
+	allocateFrames(requiredFrames, processID, frames);
 
 	// Increment paging in counter
 	numPagedIn += requiredFrames;
 
-	return reinterpret_cast<void*>(frameIndex);
+	return reinterpret_cast<void*>(frames.front() + 1);
 }
 
 void PagingAllocator::deallocate(std::shared_ptr<Process> process) {
-	size_t processID = process->getPID();
-	size_t deallocatedFrames = 0;
-
-	// Find and free all frames allocated to this process
-	auto it = std::find_if(frameMap.begin(), frameMap.end(),
-		[processID](const auto& entry) { return entry.second == processID; });
-
-	while (it != frameMap.end()) {
-		size_t frameIndex = it->first;
-		deallocateFrames(1, frameIndex);
-		deallocatedFrames++;
-		it = std::find_if(frameMap.begin(), frameMap.end(),
-			[processID](const auto& entry) { return entry.second == processID; });
+	std::lock_guard<std::mutex> lock(allocatorMutex);
+
+	// Release exactly the frames this process holds
+	auto it = processFrames.find(process->getPID());
+	if (it == processFrames.end()) {
+		return;
 	}
 
+	deallocateFrames(it->second);
+
 	// Increment paging out counter
-	numPagedOut += deallocatedFrames;
+	numPagedOut += it->second.size();
+	processFrames.erase(it);
 }
 
 
-std::string PagingAllocator::visualizeMemory() {
-	std::ostringstream oss;
-	oss << "Paging Memory Visualization:\n";
+std::string PagingAllocator::visualizeMemory(bool changedOnly) {
+	// Owners are published with atomic stores, so no allocator lock is needed here
+	std::vector<uint32_t> owners(numFrames);
 	for (size_t frameIndex = 0; frameIndex < numFrames; ++frameIndex) {
-		auto it = frameMap.find(frameIndex);
-		if (it != frameMap.end()) {
-			oss << "Frame " << frameIndex << " -> Process ID " << it->second << "\n";
-		} else {
-			oss << "Frame " << frameIndex << " -> Free\n";
-		}
+		owners[frameIndex] = std::atomic_ref<uint32_t>(frameOwner[frameIndex]).load(std::memory_order_relaxed);
 	}
+
+	std::ostringstream oss;
+	oss << "Paging Memory Visualization:\n";
+	oss << view.render(std::move(owners), "Frame", changedOnly);
 	oss << "=========================\n";
 	return oss.str();
 }
 
-size_t PagingAllocator::allocateFrames(size_t numFrames, size_t processID) {
-	size_t frameIndex = freeFrameList.back();
-	freeFrameList.pop_back();
-
-	// Map allocared frames to the process ID
-	for (size_t i = 0; i < numFrames; ++i) {
-		frameMap[frameIndex + i] = processID;
+size_t PagingAllocator::findFreeRun(size_t length) const {
+	size_t runStart = 0;
+	size_t runLength = 0;
+
+	for (size_t word = 0; word < freeBitmap.size(); ++word) {
+		uint64_t bits = freeBitmap[word];
+		size_t pos = 0;
+
+		while (pos < 64) {
+			uint64_t rest = bits >> pos;
+			if (rest == 0) { // rest of the word is in use
+				runLength = 0;
+				break;
+			}
+
+			int used = std::countr_zero(rest);
+			if (used > 0) {
+				runLength = 0;
+				pos += used;
+				continue;
+			}
+
+			int free = std::countr_one(rest);
+			if (runLength == 0) {
+				runStart = word * 64 + pos;
+			}
+			runLength += free;
+			if (runLength >= length) {
+				return runStart;
+			}
+			pos += free; // a run reaching bit 63 continues into the next word
+		}
 	}
-	return frameIndex;
+	return numFrames;
 }
 
-void PagingAllocator::deallocateFrames(size_t numFrames, size_t frameIndex) {
-	// Remove mapping 
-	for (size_t i = 0; i < numFrames; ++i) {
-		frameMap.erase(frameIndex + i);
+void PagingAllocator::allocateFrames(size_t numFrames, size_t processID, std::vector<size_t>& frames) {
+	// Prefer one contiguous run; paging does not require it, so fall back to any free frames
+	size_t runStart = findFreeRun(numFrames);
+	size_t word = 0;
+
+	while (frames.size() < numFrames) {
+		size_t frameIndex;
+		if (runStart < this->numFrames) {
+			frameIndex = runStart + frames.size();
+		}
+		else {
+			while (freeBitmap[word] == 0) {
+				word++;
+			}
+			frameIndex = word * 64 + std::countr_zero(freeBitmap[word]);
+		}
+
+		// Map allocated frame to the process ID
+		freeBitmap[frameIndex / 64] &= ~(uint64_t{ 1 } << (frameIndex % 64));
+		std::atomic_ref<uint32_t>(frameOwner[frameIndex]).store(static_cast<uint32_t>(processID), std::memory_order_relaxed);
+		frames.push_back(frameIndex);
 	}
+	freeFrameCount -= numFrames;
+}
 
-	// Add back to free frame list
-	for (size_t i = 0; i < numFrames; ++i) {
-		freeFrameList.push_back(frameIndex + i);
+void PagingAllocator::deallocateFrames(const std::vector<size_t>& frames) {
+	// Remove mapping and mark the frames free again
+	for (size_t frameIndex : frames) {
+		std::atomic_ref<uint32_t>(frameOwner[frameIndex]).store(NO_OWNER, std::memory_order_relaxed);
+		freeBitmap[frameIndex / 64] |= uint64_t{ 1 } << (frameIndex % 64);
 	}
-}
\ No newline at end of file
+	freeFrameCount += frames.size();
+}
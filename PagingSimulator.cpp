@@ -0,0 +1,207 @@
+#include "PagingSimulator.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+    constexpr uint32_t NOT_RESIDENT = UINT32_MAX;
+}
+
+bool PagingSimulator::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "fifo") policy = Policy::FIFO;
+    else if (name == "lru") policy = Policy::LRU;
+    else if (name == "clock") policy = Policy::CLOCK;
+    else if (name == "opt") policy = Policy::OPT;
+    else return false;
+    return true;
+}
+
+std::string PagingSimulator::policyName(Policy policy) {
+    switch (policy) {
+    case Policy::FIFO: return "fifo";
+    case Policy::LRU: return "lru";
+    case Policy::CLOCK: return "clock";
+    case Policy::OPT: return "opt";
+    }
+    return "unknown";
+}
+
+size_t PagingSimulator::densePages(const std::vector<PageAccess>& trace, std::vector<uint32_t>& pages, std::vector<bool>& writes) {
+    std::unordered_map<uint64_t, uint32_t> ids;
+    pages.resize(trace.size());
+    writes.resize(trace.size());
+    for (size_t i = 0; i < trace.size(); ++i) {
+        uint64_t key = (static_cast<uint64_t>(trace[i].processId) << 32) | trace[i].pageNumber;
+        auto [it, inserted] = ids.try_emplace(key, static_cast<uint32_t>(ids.size()));
+        pages[i] = it->second;
+        writes[i] = trace[i].isWrite;
+    }
+    return ids.size();
+}
+
+PagingSimulator::Result PagingSimulator::run(const std::vector<uint32_t>& pages, const std::vector<bool>& writes,
+    size_t numPages, Policy policy, size_t numFrames) {
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+    result.accesses = pages.size();
+    if (numFrames == 0) {
+        result.faults = pages.size();
+        return result;
+    }
+
+    std::vector<uint32_t> frameOf(numPages, NOT_RESIDENT);
+    std::vector<uint32_t> pageIn(numFrames, NOT_RESIDENT);
+    std::vector<uint8_t> dirty(numFrames, 0);
+    std::vector<uint8_t> referenced(numFrames, 0);    // Clock
+    std::vector<uint32_t> prev(numFrames), next(numFrames);  // LRU list, head = most recent
+    uint32_t head = NOT_RESIDENT, tail = NOT_RESIDENT;
+    size_t used = 0;
+    size_t hand = 0;                                  // FIFO / Clock
+
+    // OPT: index of each access's next use of the same page
+    std::vector<size_t> nextUse;
+    std::vector<size_t> frameNextUse;
+    std::priority_queue<std::pair<size_t, uint32_t>> farthest;  // (next use, frame), stale entries skipped
+    if (policy == Policy::OPT) {
+        nextUse.resize(pages.size());
+        std::vector<size_t> seen(numPages, SIZE_MAX);
+        for (size_t i = pages.size(); i-- > 0;) {
+            nextUse[i] = seen[pages[i]];
+            seen[pages[i]] = i;
+        }
+        frameNextUse.assign(numFrames, SIZE_MAX);
+    }
+
+    auto unlink = [&](uint32_t frame) {
+        if (prev[frame] != NOT_RESIDENT) next[prev[frame]] = next[frame]; else head = next[frame];
+        if (next[frame] != NOT_RESIDENT) prev[next[frame]] = prev[frame]; else tail = prev[frame];
+    };
+    auto pushFront = [&](uint32_t frame) {
+        prev[frame] = NOT_RESIDENT;
+        next[frame] = head;
+        if (head != NOT_RESIDENT) prev[head] = frame; else tail = frame;
+        head = frame;
+    };
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        uint32_t page = pages[i];
+        uint32_t frame = frameOf[page];
+
+        if (frame == NOT_RESIDENT) {
+            result.faults++;
+            if (used < numFrames) {
+                frame = static_cast<uint32_t>(used++);
+            }
+            else {
+                switch (policy) {
+                case Policy::FIFO:
+                    frame = static_cast<uint32_t>(hand);
+                    hand = (hand + 1) % numFrames;
+                    break;
+                case Policy::CLOCK:
+                    while (referenced[hand]) {
+                        referenced[hand] = 0;
+                        hand = (hand + 1) % numFrames;
+                    }
+                    frame = static_cast<uint32_t>(hand);
+                    hand = (hand + 1) % numFrames;
+                    break;
+                case Policy::LRU:
+                    frame = tail;
+                    unlink(frame);
+                    break;
+                case Policy::OPT:
+                    while (farthest.top().first != frameNextUse[farthest.top().second]) {
+                        farthest.pop();
+                    }
+                    frame = farthest.top().second;
+                    farthest.pop();
+                    break;
+                }
+                if (dirty[frame]) {
+                    result.writeBacks++;
+                }
+                frameOf[pageIn[frame]] = NOT_RESIDENT;
+            }
+            pageIn[frame] = page;
+            frameOf[page] = frame;
+            dirty[frame] = 0;
+        }
+        else if (policy == Policy::LRU) {
+            unlink(frame);
+        }
+
+        if (writes[i]) dirty[frame] = 1;
+        referenced[frame] = 1;
+        if (policy == Policy::LRU) {
+            pushFront(frame);
+        }
+        else if (policy == Policy::OPT) {
+            frameNextUse[frame] = nextUse[i];
+            farthest.push({ nextUse[i], frame });
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int PagingSimulator::runFromCommandLine(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " --replay <trace file> <fifo|lru|clock|opt|all> <frames>" << std::endl;
+        return 1;
+    }
+
+    std::vector<Policy> policies;
+    std::string policyArg = argv[3];
+    Policy policy;
+    if (policyArg == "all") {
+        policies = { Policy::FIFO, Policy::LRU, Policy::CLOCK, Policy::OPT };
+    }
+    else if (parsePolicy(policyArg, policy)) {
+        policies = { policy };
+    }
+    else {
+        std::cerr << "Unknown policy: " << policyArg << std::endl;
+        return 1;
+    }
+
+    size_t numFrames = 0;
+    try {
+        numFrames = std::stoull(argv[4]);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid frame count: " << argv[4] << std::endl;
+        return 1;
+    }
+
+    std::vector<PageAccess> trace;
+    size_t frameSize = 0;
+    if (!readAccessTrace(argv[2], trace, frameSize)) {
+        std::cerr << "Could not read trace file: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::vector<uint32_t> pages;
+    std::vector<bool> writes;
+    size_t numPages = densePages(trace, pages, writes);
+
+    std::cout << "Trace: " << argv[2] << " (" << trace.size() << " accesses, " << numPages
+        << " distinct pages, " << frameSize << " bytes per frame)" << std::endl;
+    std::cout << std::left << std::setw(8) << "Policy" << std::setw(10) << "Frames" << std::setw(12) << "Faults"
+        << std::setw(12) << "FaultRate" << std::setw(14) << "WriteBacks" << std::setw(16) << "WrittenBytes"
+        << "Accesses/s" << std::endl;
+
+    for (Policy p : policies) {
+        Result result = run(pages, writes, numPages, p, numFrames);
+        double rate = result.accesses ? static_cast<double>(result.faults) / result.accesses : 0.0;
+        double throughput = result.seconds > 0 ? result.accesses / result.seconds : 0.0;
+        std::cout << std::setw(8) << policyName(p) << std::setw(10) << numFrames << std::setw(12) << result.faults
+            << std::setw(12) << std::fixed << std::setprecision(4) << rate << std::setw(14) << result.writeBacks
+            << std::setw(16) << result.writeBacks * frameSize << std::setprecision(0) << throughput << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "AccessTrace.h"
+
+// Offline replay of a recorded access trace against a page replacement
+// policy and frame count. OPT (Belady) gives the lower bound on faults.
+class PagingSimulator {
+public:
+    enum class Policy { FIFO, LRU, CLOCK, OPT };
+
+    struct Result {
+        size_t accesses = 0;
+        size_t faults = 0;
+        size_t writeBacks = 0;      // Dirty pages evicted
+        double seconds = 0.0;
+    };
+
+    static bool parsePolicy(const std::string& name, Policy& policy);
+    static std::string policyName(Policy policy);
+
+    // Pages must already be numbered densely (see densePages)
+    static Result run(const std::vector<uint32_t>& pages, const std::vector<bool>& writes, size_t numPages,
+        Policy policy, size_t numFrames);
+
+    // Maps (pid, page) pairs to 0..n-1 so the policies can use flat arrays
+    static size_t densePages(const std::vector<PageAccess>& trace, std::vector<uint32_t>& pages, std::vector<bool>& writes);
+
+    // --replay <trace file> <fifo|lru|clock|opt|all> <frames>
+    static int runFromCommandLine(int argc, char* argv[]);
+};
@@ -2,15 +2,65 @@
 
 
 Process::Process(int id, const std::string& name, int minIns, int maxIns, size_t memoryRequired, size_t numPages)
-	: pid(id), name(name), state(State::NEW), programCounter(0), memoryRequired(memoryRequired), numPages(numPages)
+	: pid(id), state(State::NEW), allocated(false), programCounter(0), numPages(numPages),
+	cold(std::make_unique<Cold>())
 {
-	getSymbolTable(); 
-	instructions = CommandList();
+	cold->name = name;
+	cold->memoryRequired = memoryRequired;
+	cold->arrivalTime = std::chrono::system_clock::now();
+	// The symbol table is created on first use
 	if (memoryRequired > 0) generateInstructionsBetween(minIns, maxIns);
-	arrivalTime = std::chrono::system_clock::now();
-	
-	allocated = false; // Initially not allocated
-	pageTable.reserve(numPages);
+}
+
+Process::Process(const Process& other)
+	: pid(other.pid), state(other.state), allocated(other.allocated), programCounter(other.programCounter), numPages(other.numPages), instructions(other.instructions), accessCursor(other.accessCursor),
+	cold(std::make_unique<Cold>(*other.cold)) {
+}
+
+Process& Process::operator=(const Process& other) {
+	if (this != &other) {
+		pid = other.pid;
+		state = other.state;
+		allocated = other.allocated;
+		programCounter = other.programCounter;
+		numPages = other.numPages;
+		instructions = other.instructions;
+		accessCursor = other.accessCursor;
+		cold = std::make_unique<Cold>(*other.cold);
+	}
+	return *this;
+}
+
+Process::~Process() {
+	// The commands live in the arena held by cold, so they go first
+	instructions.clear();
+}
+
+Process::Cold::Cold(const Cold& other)
+	: name(other.name), symbolTable(other.symbolTable),
+	arrivalTime(other.arrivalTime), startTime(other.startTime), endTime(other.endTime),
+	memoryRequired(other.memoryRequired), deadline(other.deadline),
+	realtime(other.realtime), deadlineMissed(other.deadlineMissed), nice(other.nice), tickets(other.tickets), group(other.group) {
+	// Anything shared with the original lives in its arena, so a copy's arena is chained to it
+	if (other.arena) {
+		arena = std::make_shared<ProcessArena>(other.arena);
+	}
+	if (other.logs) {
+		logs = std::pmr::polymorphic_allocator<LogList>(resource()).new_object<LogList>(*other.logs);
+	}
+}
+
+Process::Cold::~Cold() {
+	if (logs) {
+		std::pmr::polymorphic_allocator<LogList>(arena->resource()).delete_object(logs);
+	}
+}
+
+std::pmr::memory_resource* Process::Cold::resource() {
+	if (!arena) {
+		arena = std::make_shared<ProcessArena>();
+	}
+	return arena->resource();
 }
 
 
@@ -29,20 +79,20 @@ void Process::generateInstructionsBetween(int min, int max) {
 
 		switch (cmdType) {
 			case 0: // SLEEP
-				this->instructions[i] = std::make_shared<SleepCommand>(this->pid, rand() % 1000 + 1);
+				this->instructions[i] = makeCommand<SleepCommand>(this->pid, rand() % 1000 + 1);
 				break;
 			case 1: // READ
 				varName = possibleVars[rand() % possibleVars.size()];
 				address = static_cast<uintptr_t>(rand() % 1000); 
-				this->instructions[i] = std::make_shared<ReadCommand>(this->pid, getSymbolTable(), varName, address);
+				this->instructions[i] = makeCommand<ReadCommand>(this->pid, getSymbolTable(), varName, address);
 				break;
 			case 2: // WRITE
 				varName = possibleVars[rand() % possibleVars.size()];
 				value = rand() % 100; // Random value to write
-				this->instructions[i] = std::make_shared<WriteCommand>(this->pid, getSymbolTable(), address, value);
+				this->instructions[i] = makeCommand<WriteCommand>(this->pid, getSymbolTable(), address, value);
 				break;
 			default: // Do Nothing
-				this->instructions[i] = std::make_shared<SleepCommand>(this->pid, 100);
+				this->instructions[i] = makeCommand<SleepCommand>(this->pid, 100);
 				break;
 		}
 	}
@@ -53,12 +103,38 @@ void Process::setCustomInstructions(CommandList cmds) {
     this->instructions = std::move(cmds);
     this->programCounter = 0; // Reset 
 
-	this->memoryRequired = 2;
+	this->cold->memoryRequired = 2;
 	this->numPages = 2;
 
 	setState(State::READY);
 }
 
+std::shared_ptr<Process> Process::clone(int newPid, const std::string& newName) const {
+	// Built empty rather than copied, so nothing is allocated from this process's arena
+	auto child = std::make_shared<Process>(newPid, newName, 0, 0, 0, this->numPages);
+	std::pmr::memory_resource* resource = child->cold->resource();
+	child->cold->nice = this->cold->nice;
+	if (this->cold->realtime) {
+		child->setDeadline(this->cold->deadline);
+	}
+	child->cold->tickets = this->cold->tickets;
+	child->cold->group = this->cold->group;
+	child->programCounter = this->programCounter;
+	child->accessCursor = this->accessCursor;
+	child->cold->memoryRequired = this->cold->memoryRequired;
+	if (this->cold->symbolTable) {
+		child->cold->symbolTable = std::allocate_shared<SymbolTable>(
+			std::pmr::polymorphic_allocator<SymbolTable>(resource), *this->cold->symbolTable, resource);
+	}
+	child->instructions.reserve(this->instructions.size());
+	for (const auto& cmd : this->instructions) {
+		child->instructions.push_back(cmd->clone(newPid, child->cold->symbolTable, resource));
+	}
+
+	child->state = State::READY;
+	return child;
+}
+
 /*============== GETTERS ================*/
 Process::State Process::getState() const {
 	return this->state;
@@ -73,7 +149,7 @@ int Process::getCmdListSize() const {
 }
 
 std::string Process::getName() const {
-	return this->name;
+	return this->cold->name;
 }
 
 std::string Process::getCounter() const {
@@ -81,30 +157,32 @@ std::string Process::getCounter() const {
 }
 
 Process::TimePoint Process::getArrivalTime() const {
-	return this->arrivalTime;
+	return this->cold->arrivalTime;
 }
 
 Process::TimePoint Process::getEndTime() const {
-	return this->endTime;
+	return this->cold->endTime;
 }
 
 Process::TimePoint Process::getStartTime() const {
-	return this->startTime;
+	return this->cold->startTime;
 }
 
-const std::vector<Process::LogEntry>& Process::getLogs() const {
-    return logs;
+const Process::LogList& Process::getLogs() const {
+    static const LogList none;
+    return cold->logs ? *cold->logs : none;
 }
 
 size_t Process::getMemoryRequired() const {
-	return this->memoryRequired;
+	return this->cold->memoryRequired;
 }
 
 std::shared_ptr<SymbolTable> Process::getSymbolTable() {
-	if (!symbolTable) {
-		symbolTable = std::make_shared<SymbolTable>();
+	if (!cold->symbolTable) {
+		std::pmr::memory_resource* resource = cold->resource();
+		cold->symbolTable = std::allocate_shared<SymbolTable>(std::pmr::polymorphic_allocator<SymbolTable>(resource), resource);
 	}
-	return symbolTable;
+	return cold->symbolTable;
 }
 
 /*============== SETTERS ================*/
@@ -113,15 +191,15 @@ void Process::setState(State newState) {
 }
 
 void Process::setEndTime(TimePoint endTime) {
-	this->endTime = endTime;
+	this->cold->endTime = endTime;
 }
 
 void Process::setStartTime(TimePoint startTime) {
-	this->startTime = startTime;
+	this->cold->startTime = startTime;
 }
 
 void Process::executeCurrentCommand(int core) const {  
-    std::shared_ptr<ICommand> currentCommand = this->instructions[this->programCounter];  
+    const std::shared_ptr<ICommand>& currentCommand = this->instructions[this->programCounter];  
 
     currentCommand->execute();  
     if (currentCommand->getCommandType() == ICommand::PRINT) {  
@@ -131,6 +209,10 @@ void Process::executeCurrentCommand(int core) const {
     const_cast<Process*>(this)->addLog(core, currentCommand->getOutput());  
 }
 
+ICommand::CommandType Process::getCurrentCommandType() const {
+	return this->instructions[this->programCounter]->getCommandType();
+}
+
 void Process::moveToNextLine() {
 	this->programCounter++;
 }
@@ -145,7 +227,12 @@ bool Process::isFinished() const {
 }
 
 void Process::addLog(int core, const std::string& message) {
-    logs.push_back(LogEntry{ std::chrono::system_clock::now(), core, message });
+    // The message shares the log list's resource, the process's arena
+    if (!cold->logs) {
+        cold->logs = std::pmr::polymorphic_allocator<LogList>(cold->resource()).new_object<LogList>();
+    }
+    cold->logs->push_back(LogEntry{ std::chrono::system_clock::now(), core,
+        std::pmr::string(message, cold->logs->get_allocator().resource()) });
 }
 
 void logHelloWorld(Process* proc, int coreID) {
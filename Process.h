@@ -4,25 +4,44 @@
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <cstdint>
 #include "SymbolTable.h"
 #include "Commands.h"
+#include "PageAccessModel.h"
+#include "ProcessArena.h"
 
 class Process {
 public:
-	enum class State {
+	enum class State : uint8_t {
 		NEW,
 		RUNNING,
 		WAITING,
 		READY,
+		SUSPENDED,
 		TERMINATED
 	};
 
 	typedef std::vector<std::shared_ptr<ICommand>> CommandList;
 	typedef std::chrono::system_clock::time_point TimePoint;
 	typedef std::shared_ptr<SymbolTable> TablePtr;
+	static constexpr uint32_t DEFAULT_TICKETS = 100;
 	Process(int id, const std::string& n, int minIns, int maxIns, size_t memoryRequired, size_t numPages);
+	// Copies share the commands and symbol table, but allocate from an arena of their own
+	Process(const Process& other);
+	Process& operator=(const Process& other);
+	~Process();
 	void generateInstructionsBetween(int min, int max);
 	void setCustomInstructions(CommandList cmds);
+	// Fork-like duplicate: same program and counter, its own arena and copy of the symbol table.
+	// No core may be running this process meanwhile (see Scheduler::cloneProcess).
+	std::shared_ptr<Process> clone(int newPid, const std::string& newName) const;
+
+	// Command allocated from this process's arena, for generated and custom programs
+	template <typename T, typename... Args>
+	std::shared_ptr<ICommand> makeCommand(Args&&... args) {
+		return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(cold->resource()), std::forward<Args>(args)...);
+	}
 
 	State		getState() const;
 	int			getPID() const;
@@ -38,16 +57,30 @@ public:
 	//void        setAllocationIndex(void* i) { allocIndex = i; }
 	//void*       getAllocationIndex() { return allocIndex; }
 	void        setAllocation(bool a) { allocated = a; }
+	// Read by the schedulers from the process table, which copies them at registration
+	void        setNice(int n) { cold->nice = static_cast<int8_t>(n); }
+	int         getNice() const { return cold->nice; }
+	void        setDeadline(uint64_t tick) { cold->realtime = true; cold->deadline = tick; }
+	bool        isRealtime() const { return cold->realtime; }
+	uint64_t    getDeadline() const { return cold->deadline; }	// absolute CPU tick
+	void        markDeadlineMissed() { cold->deadlineMissed = true; }
+	bool        hasMissedDeadline() const { return cold->deadlineMissed; }
+	void        setTickets(uint32_t t) { cold->tickets = t; }
+	uint32_t    getTickets() const { return cold->tickets; }	// share under the lottery and stride schedulers
+	void        setGroup(const std::string& g) { cold->group = g; }
+	const std::string& getGroup() const { return cold->group; }	// empty for the default group
 	bool		isAllocated() { return allocated; }
 
 	//void        setNumPages(size_t n) { numPages = n; }
 	size_t      getNumPages() const { return numPages; }
+	PageAccessCursor& getAccessCursor() { return accessCursor; }
 
 	void setState(State newState);
 	void setStartTime(TimePoint startTime);
 	void setEndTime(TimePoint endTime);
 
 	void executeCurrentCommand(int core) const;
+	ICommand::CommandType getCurrentCommandType() const;	// process must not be finished
 	void moveToNextLine();
 
 	// Get the remaining number of instructions 
@@ -59,41 +92,51 @@ public:
 	struct LogEntry {
 		std::chrono::system_clock::time_point timestamp;
 		int core;
-		std::string message;
+		std::pmr::string message;
 	};
+	typedef std::pmr::vector<LogEntry> LogList;
 
 	void addLog(int core, const std::string& message);
-	const std::vector<LogEntry>& getLogs() const;
+	const LogList& getLogs() const;
 
 private:
+	// State a core changes while running the process, touched on every instruction.
+	// What the schedulers decide on lives in the process table (see ProcessSlot).
 	int pid;
-	std::string name;
 	State state;
-
-	// Subroutines
-	CommandList instructions;
+	bool allocated;
 	int programCounter;
-
-	// Symbol table
-	TablePtr symbolTable;
-	std::unordered_map<uintptr_t, std::string> variables;
-
-	// TODO: Stack
-	// TODO: Heap
-
-	// Scheduler tracking
-	int turnaroundTime;
-	int waitingTime;
-	TimePoint arrivalTime;
-	TimePoint startTime;
-	TimePoint endTime;
-
-	std::vector<LogEntry> logs;
-
-	// Memory Allocation 
-	size_t	memoryRequired;
-	//void*	allocIndex;
-	bool	allocated;
-	size_t  numPages;
-	std::unordered_map<void*, bool> pageTable;
+	size_t numPages;
+	CommandList instructions;
+	PageAccessCursor accessCursor;
+
+	// Everything only the consoles and reports read lives in a side allocation
+	struct Cold {
+		std::shared_ptr<ProcessArena> arena;    // first, so it is released last; null until first needed
+		std::string name;
+		TablePtr symbolTable;
+		TimePoint arrivalTime;
+		TimePoint startTime;
+		TimePoint endTime;
+		LogList* logs = nullptr;        // in the arena, from the first log on
+		size_t memoryRequired = 0;
+		uint64_t deadline = 0;
+		bool realtime = false;      // has a deadline, scheduled in the EDF class
+		bool deadlineMissed = false;
+		int8_t nice = 0;            // -20..19, weights the process under the fair scheduler
+		uint32_t tickets = DEFAULT_TICKETS;
+		std::string group;
+
+		Cold() = default;
+		// A copy never allocates from the arena of the original, which a core may be using
+		Cold(const Cold& other);
+		~Cold();
+		Cold& operator=(const Cold&) = delete;
+
+		std::pmr::memory_resource* resource();	// the arena, created on first use
+	};
+	// Never null. Allocated with the process rather than on first use, since the name
+	// and arrival time are set at construction; the arena in it waits for the first
+	// allocation, so a process that never allocates does not pay for one.
+	std::unique_ptr<Cold> cold;
 };
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "ProcessArena.h"
+#include <iomanip>
+#include <sstream>
+
+void* ProcessArena::CountingResource::do_allocate(size_t size, size_t alignment) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return upstream->allocate(size, alignment);
+}
+
+void ProcessArena::CountingResource::do_deallocate(void* p, size_t size, size_t alignment) {
+    upstream->deallocate(p, size, alignment);
+}
+
+ProcessArena::CountingResource& ProcessArena::heap() {
+    static CountingResource resource(std::pmr::new_delete_resource(), heapBlocks, heapBytes);
+    return resource;
+}
+
+ProcessArena::ProcessArena(size_t initialBytes)
+    : buffer(initialBytes, &heap()) {
+    liveArenas++;
+}
+
+ProcessArena::ProcessArena(std::shared_ptr<ProcessArena> source, size_t initialBytes)
+    : ProcessArena(initialBytes) {
+    this->source = std::move(source);
+}
+
+ProcessArena::~ProcessArena() {
+    liveArenas--;
+}
+
+void* ProcessArena::do_allocate(size_t size, size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return buffer.allocate(size, alignment);
+}
+
+void ProcessArena::do_deallocate(void* p, size_t size, size_t alignment) {
+    buffer.deallocate(p, size, alignment);
+}
+
+ArenaStats ProcessArena::getStats() {
+    ArenaStats stats;
+    stats.liveArenas = liveArenas.load();
+    stats.allocations = allocations.load();
+    stats.allocatedBytes = allocatedBytes.load();
+    stats.heapBlocks = heapBlocks.load();
+    stats.heapBytes = heapBytes.load();
+    return stats;
+}
+
+std::string ProcessArena::report() {
+    ArenaStats stats = getStats();
+    std::ostringstream out;
+    out << "Process arenas: " << stats.liveArenas << " live" << std::endl;
+    out << "  Allocations served: " << stats.allocations << " (" << stats.allocatedBytes << " bytes)" << std::endl;
+    out << "  Heap allocations:   " << stats.heapBlocks << " (" << stats.heapBytes << " bytes)" << std::endl;
+    if (stats.heapBlocks > 0) {
+        out << "  Allocations per heap allocation: " << std::fixed << std::setprecision(1)
+            << static_cast<double>(stats.allocations) / stats.heapBlocks << std::endl;
+    }
+    return out.str();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+// Totals across all process arenas, for memory-footprint
+struct ArenaStats {
+    size_t liveArenas = 0;
+    size_t allocations = 0;         // small allocations served by arenas
+    size_t allocatedBytes = 0;
+    size_t heapBlocks = 0;          // blocks the arenas took from the heap for them
+    size_t heapBytes = 0;
+};
+
+// Monotonic arena owned by one process. The process's commands, symbol table
+// and logs are carved out of a few large heap blocks, so a core running it does
+// not go to malloc per instruction, and everything is returned in one go when
+// the process is destroyed.
+// Not thread-safe: only the thread currently running the process allocates.
+// A process creates its arena on first allocation (see Process::Cold), and a copy
+// of a process gets an arena of its own, chained to the source's arena so the
+// commands it still shares with the source stay alive.
+// The arena is its own memory resource, and all arenas take their heap blocks
+// through one shared counting resource, so an arena costs one object of about
+// 100 bytes plus the blocks it has taken.
+class ProcessArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t INITIAL_BYTES = 4096;
+
+    explicit ProcessArena(size_t initialBytes = INITIAL_BYTES);
+    explicit ProcessArena(std::shared_ptr<ProcessArena> source, size_t initialBytes = INITIAL_BYTES);
+    ~ProcessArena();
+    ProcessArena(const ProcessArena&) = delete;
+    ProcessArena& operator=(const ProcessArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return this; }
+
+    static ArenaStats getStats();
+    static std::string report();
+
+private:
+    // Forwards to another resource, adding each request to a pair of counters
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        CountingResource(std::pmr::memory_resource* upstream, std::atomic<size_t>& count, std::atomic<size_t>& bytes)
+            : upstream(upstream), count(count), bytes(bytes) {}
+
+    private:
+        std::pmr::memory_resource* upstream;
+        std::atomic<size_t>& count;
+        std::atomic<size_t>& bytes;
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    inline static std::atomic<size_t> liveArenas{ 0 };
+    inline static std::atomic<size_t> allocations{ 0 };
+    inline static std::atomic<size_t> allocatedBytes{ 0 };
+    inline static std::atomic<size_t> heapBlocks{ 0 };
+    inline static std::atomic<size_t> heapBytes{ 0 };
+
+    static CountingResource& heap();                // heap blocks taken by all arenas
+
+    std::shared_ptr<ProcessArena> source;           // null unless this is a copy's arena
+    std::pmr::monotonic_buffer_resource buffer;
+
+    // Allocations handed out, counted on their way to the buffer
+    void* do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void* p, size_t size, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
@@ -5,8 +5,11 @@ ProcessConsole::ProcessConsole(const String pName) : Console("PROCESS_CONSOLE")
 	this->p = ProcessScheduler::getInstance().fetchProcessByName(pName, 0);
 }
 
-ProcessConsole::ProcessConsole(const String pName, size_t memSize) : Console("PROCESS_CONSOLE") {
-	this->p = ProcessScheduler::getInstance().fetchProcessByName(pName, memSize);
+ProcessConsole::ProcessConsole(std::shared_ptr<Process> process, const ScreenOptions& options) : Console("PROCESS_CONSOLE") {
+	this->p = std::move(process);
+	p->setNice(options.nice);
+	p->setTickets(options.tickets);
+	p->setGroup(options.group);
 	ProcessScheduler::getInstance().addProcess(p);
 }
 
@@ -32,6 +35,7 @@ void ProcessConsole::display() const {
     std::cout << std::endl;
     std::cout << "Current instruction line: " << p->getCounter() << std::endl;
     std::cout << "Lines of code: " << p->getCmdListSize() << std::endl;
+    ProcessScheduler::getInstance().showProcessMemory(p->getPID());
     if (p->isFinished()) {
         std::cout << "Finished!" << std::endl;
     }
@@ -71,6 +75,7 @@ void ProcessConsole::process() {
 			std::cout << std::endl;
 			std::cout << "Current instruction line: " << p->getCounter() << std::endl;
 			std::cout << "Lines of code: " << p->getCmdListSize() << std::endl;
+			ProcessScheduler::getInstance().showProcessMemory(p->getPID());
 			if (p->isFinished()) {
 				std::cout << "Finished!" << std::endl;
 			}
@@ -97,18 +102,18 @@ void ProcessConsole::setCustomCommands(const std::vector<std::vector<std::string
 		int pID = p->getPID();
 		std::shared_ptr<SymbolTable> symbolTable = p->getSymbolTable();
 		if (cmd[0] == "DECLARE") { // DECLARE varName value
-			cPtr = std::make_shared<DeclareCommand>(pID, symbolTable, cmd[1], std::stoi(cmd[2]));
+			cPtr = p->makeCommand<DeclareCommand>(pID, symbolTable, cmd[1], std::stoi(cmd[2]));
 			commandList.push_back(cPtr);
 			continue;
 		} 
 		else if (cmd[0] == "ADD") { // ADD out var1 var2
-			cPtr = std::make_shared<AddCommand>(pID, symbolTable, cmd[1], cmd[2], cmd[3]);
+			cPtr = p->makeCommand<AddCommand>(pID, symbolTable, cmd[1], cmd[2], cmd[3]);
 			commandList.push_back(cPtr);
 			continue;
 		} 
 		else if (cmd[0] == "READ") { // READ outVar addr
 			uintptr_t address = static_cast<uintptr_t>(std::stoull(cmd[2], nullptr, 0));
-			cPtr = std::make_shared<ReadCommand>(pID, symbolTable, cmd[1], address);
+			cPtr = p->makeCommand<ReadCommand>(pID, symbolTable, cmd[1], address);
 			commandList.push_back(cPtr);
 			continue;
 		}
@@ -116,15 +121,15 @@ void ProcessConsole::setCustomCommands(const std::vector<std::vector<std::string
 			uintptr_t address = static_cast<uintptr_t>(std::stoull(cmd[1], nullptr, 0));
 			if (std::all_of(cmd[2].begin(), cmd[2].end(), ::isdigit)) { // If value is a number
 				uint16_t value = static_cast<uint16_t>(std::stoi(cmd[2]));
-				cPtr = std::make_shared<WriteCommand>(pID, symbolTable, address, value);
+				cPtr = p->makeCommand<WriteCommand>(pID, symbolTable, address, value);
 			} else { // If value is a variable name
-				cPtr = std::make_shared<WriteCommand>(pID, symbolTable, address, cmd[2]);
+				cPtr = p->makeCommand<WriteCommand>(pID, symbolTable, address, cmd[2]);
 			}
 			commandList.push_back(cPtr);
 			continue;
 		} 
 		else if (cmd[0] == "PRINT") { // PRINT "message "
-			cPtr = std::make_shared<PrintCommand>(pID, symbolTable, cmd);
+			cPtr = p->makeCommand<PrintCommand>(pID, symbolTable, cmd);
 			commandList.push_back(cPtr);
 			continue;
 		}
@@ -6,10 +6,18 @@
 #include "Process.h"
 #include "ProcessScheduler.h"
 
+// Scheduling attributes given to screen -s after the memory size
+struct ScreenOptions {
+	int nice = 0;
+	uint64_t deadlineTicks = 0;	// relative to now, 0 for a normal process
+	uint32_t tickets = Process::DEFAULT_TICKETS;
+	std::string group;			// empty for the default group
+};
+
 class ProcessConsole : public Console {
 public:
 	ProcessConsole(const String pName);
-	ProcessConsole(const String pName, size_t memSize);
+	ProcessConsole(std::shared_ptr<Process> process, const ScreenOptions& options);	// schedules process
 
 	void onEnabled() override;
 	void display() const override;
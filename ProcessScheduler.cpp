@@ -1,5 +1,34 @@
 #include "ProcessScheduler.h"
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    // Pins a core thread to a host CPU, wrapping when there are more simulated cores than CPUs
+    bool pinToHostCpu(std::thread& thread, int coreID) {
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        unsigned cpu = static_cast<unsigned>(coreID) % cpus;
+#ifdef _WIN32
+        cpu %= 8 * sizeof(DWORD_PTR);   // a thread's affinity mask covers its processor group only
+        return SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << cpu) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+        (void)thread;
+        (void)cpu;
+        return false;
+#endif
+    }
+}
+
 ProcessScheduler& ProcessScheduler::getInstance() {
     static ProcessScheduler instance;
     return instance;
@@ -9,16 +38,54 @@ void ProcessScheduler::init() {
     // Calculate number of frames based on memory and frame size
     size_t numFrames = maxOverallMem / memPerFrame;
 
-    // Always use demand paging allocator as default
-    demandPagingAllocator = std::make_shared<DemandPagingAllocator>(
-        maxOverallMem, memPerFrame, numFrames, "backing_store.dat");
+    // Demand paging is the default; contiguous allocators are selected by policy name
+    FlatMemoryAllocator::Policy flatPolicy;
+    if (allocatorType == "demand-paging") {
+        demandPagingAllocator = std::make_shared<DemandPagingAllocator>(
+            maxOverallMem, memPerFrame, numFrames, "backing_store.dat");
+        demandPagingAllocator->setWorkingSetWindow(wsWindow);
+        demandPagingAllocator->setThrashingFaultRate(thrashFaultRate);
+        demandPagingAllocator->setReadaheadWindow(swapReadahead);
+        demandPagingAllocator->setSwapCacheBudget(swapCacheSize);
+        if (accessTrace != "off" && !demandPagingAllocator->startTrace(accessTrace)) {
+            std::cerr << "[WARN] Could not open access trace file: " << accessTrace << "\n";
+        }
+        memoryAllocator = demandPagingAllocator;
+    }
+    else if (allocatorType == "paging") {
+        pagingAllocator = std::make_shared<PagingAllocator>(maxOverallMem, numFrames);
+        memoryAllocator = pagingAllocator;
+    }
+    else if (FlatMemoryAllocator::parsePolicy(allocatorType, flatPolicy)) {
+        flatMemoryAllocator = std::make_shared<FlatMemoryAllocator>(maxOverallMem, memPerFrame, flatPolicy);
+        memoryAllocator = flatMemoryAllocator;
+    }
+    else {
+        throw std::runtime_error("Unknown memory allocator: " + allocatorType);
+    }
 
-    // Create scheduler with demand paging allocator
+    // Create scheduler with the selected allocator
     if (type == "fcfs") {
-        scheduler = std::make_shared<FCFSScheduler>(numCPU, *demandPagingAllocator);
+        scheduler = std::make_shared<FCFSScheduler>(numCPU, *memoryAllocator);
     }
     else if (type == "rr") {
-        scheduler = std::make_shared<RRScheduler>(numCPU, quantumCycles, *demandPagingAllocator);
+        scheduler = std::make_shared<RRScheduler>(numCPU, quantumCycles, migrationCost, *memoryAllocator);
+    }
+    else if (type == "sjf" || type == "srtf") {
+        scheduler = std::make_shared<SJFScheduler>(numCPU, quantumCycles, type == "srtf", *memoryAllocator);
+    }
+    else if (type == "mlfq") {
+        scheduler = std::make_shared<MLFQScheduler>(numCPU,
+            MLFQScheduler::parseQuanta(mlfqQuanta, mlfqLevels, quantumCycles), mlfqBoost, *memoryAllocator);
+    }
+    else if (type == "cfs") {
+        scheduler = std::make_shared<CFSScheduler>(numCPU, cfsLatency, cfsMinGranularity, *memoryAllocator);
+    }
+    else if (type == "lottery") {
+        scheduler = std::make_shared<LotteryScheduler>(numCPU, quantumCycles, lotterySeed, *memoryAllocator);
+    }
+    else if (type == "stride") {
+        scheduler = std::make_shared<StrideScheduler>(numCPU, quantumCycles, *memoryAllocator);
     }
     else {
         throw std::runtime_error("Unknown scheduler type: " + type);
@@ -33,29 +100,121 @@ void ProcessScheduler::init() {
     scheduler->setMemPerFrame(memPerFrame);
     scheduler->setMinMemPerProc(minMemPerProc);
     scheduler->setMaxMemPerProc(maxMemPerProc);
+    scheduler->setRealtimeRate(rtInsPerTick);
+    scheduler->setCpuPeriod(cpuPeriod);
+    for (const auto& [group, quota] : groupQuotas) {
+        scheduler->setGroupQuota(group, quota);
+    }
+
+    PageAccessModel model;
+    PageAccessModel::Kind kind;
+    if (!PageAccessModel::parseKind(accessModel, kind)) {
+        throw std::runtime_error("Unknown access model: " + accessModel);
+    }
+    model.setKind(kind);
+    model.setZipfExponent(zipfExponent);
+    model.setPhaseLength(phaseLength);
+    model.setPhasePages(phasePages);
+    model.setStride(accessStride);
+    model.setWriteRatio(writeRatio);
+    scheduler->setAccessModel(model);
 
     // Start scheduler threads
     std::thread(&Scheduler::schedulerThread, scheduler).detach();
+    int pinned = 0;
     for (int i = 0; i < numCPU; ++i) {
-        std::thread(&Scheduler::cpuCoreThread, scheduler, i).detach();
+        std::thread core(&Scheduler::cpuCoreThread, scheduler, i);
+        if (pinCores && pinToHostCpu(core, i)) {
+            pinned++;
+        }
+        core.detach();
+    }
+    if (pinCores && pinned < numCPU) {
+        std::cerr << "[WARN] Pinned " << pinned << " of " << numCPU << " core threads to host CPUs\n";
     }
 }
 
-void ProcessScheduler::showProcessList() const {
+void ProcessScheduler::showProcessList(const std::string& sortColumn) const {
+    static const std::vector<std::string> columns = {
+        "name", "progress", "ws", "fault-freq", "rss", "swap", "minor", "major", "written", "peak" };
+    if (!sortColumn.empty() && std::find(columns.begin(), columns.end(), sortColumn) == columns.end()) {
+        std::cout << "Unknown sort column. Use one of: name, progress, ws, fault-freq, rss, swap, minor, major, written, peak" << std::endl;
+        return;
+    }
+
+    struct Row {
+        std::shared_ptr<Process> process;
+        ProcessPagingStats stats;
+        ProcessMemoryAccounting usage;
+    };
+
+    std::vector<Row> rows;
+    for (const auto& p : scheduler->processList) {
+        if (!p) continue;
+        Row row{ p, ProcessPagingStats{}, ProcessMemoryAccounting{} };
+        if (demandPagingAllocator) {
+            row.stats = demandPagingAllocator->getProcessStats(p->getPID());
+            row.usage = demandPagingAllocator->getProcessAccounting(p->getPID());
+        }
+        rows.push_back(row);
+    }
+
+    // Name sorts alphabetically, progress by remaining instructions, the rest largest first
+    auto key = [&](const Row& row) -> double {
+        if (sortColumn == "progress") return row.process->getRemainingBurstTime();
+        if (sortColumn == "ws") return -static_cast<double>(row.stats.workingSet);
+        if (sortColumn == "fault-freq") return -row.stats.faultFrequency;
+        if (sortColumn == "rss") return -static_cast<double>(row.usage.residentPages);
+        if (sortColumn == "swap") return -static_cast<double>(row.usage.swappedPages);
+        if (sortColumn == "minor") return -static_cast<double>(row.usage.minorFaults);
+        if (sortColumn == "major") return -static_cast<double>(row.usage.majorFaults);
+        if (sortColumn == "written") return -static_cast<double>(row.usage.bytesWritten);
+        if (sortColumn == "peak") return -static_cast<double>(row.usage.peakResident);
+        return 0.0;
+    };
+    if (sortColumn == "name") {
+        std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            return a.process->getName() < b.process->getName();
+        });
+    }
+    else if (!sortColumn.empty()) {
+        std::stable_sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b) { return key(a) < key(b); });
+    }
+
     int max = 50;
     std::ostringstream out;
-    for (const auto& p : scheduler->processList) {
+    out << std::left << std::setw(16) << "Name" << std::setw(14) << "Progress"
+        << std::setw(12) << "WorkingSet" << std::setw(11) << "FaultFreq"
+        << std::setw(7) << "RSS" << std::setw(7) << "Swap" << std::setw(8) << "Minor" << std::setw(8) << "Major"
+        << std::setw(10) << "Written" << std::setw(6) << "Peak" << std::endl;
+    for (const Row& row : rows) {
         if (max <= 0) break; // Limit to max processes
-        if (!p) continue; // Skip null pointers
-        out << p->getName() << " " << p->getCounter() << std::endl;
+        std::ostringstream ws;
+        ws << row.stats.workingSet << (row.stats.suspended ? " (S)" : "");
+        out << std::setw(16) << row.process->getName() << std::setw(14) << row.process->getCounter()
+            << std::setw(12) << ws.str() << std::setw(11) << std::fixed << std::setprecision(2) << row.stats.faultFrequency
+            << std::setw(7) << row.usage.residentPages << std::setw(7) << row.usage.swappedPages
+            << std::setw(8) << row.usage.minorFaults << std::setw(8) << row.usage.majorFaults
+            << std::setw(10) << row.usage.bytesWritten << std::setw(6) << row.usage.peakResident << std::endl;
         max--;
     }
-    if (max <= 0) out << "... and " << scheduler->processList.size() - 50 << " more processes.";
+    if (max <= 0) out << "... and " << rows.size() - 50 << " more processes.";
 
     std::cout << "Process List: " << std::endl;
     std::cout << out.str() << std::endl;
 }
 
+void ProcessScheduler::showProcessMemory(int pid) const {
+    if (!demandPagingAllocator) {
+        return;
+    }
+    ProcessMemoryAccounting usage = demandPagingAllocator->getProcessAccounting(pid);
+    std::cout << "Resident pages: " << usage.residentPages << " (peak " << usage.peakResident << ")" << std::endl;
+    std::cout << "Swapped pages: " << usage.swappedPages << std::endl;
+    std::cout << "Page faults: " << usage.minorFaults << " minor, " << usage.majorFaults << " major" << std::endl;
+    std::cout << "Written to backing store: " << usage.bytesWritten << " bytes" << std::endl;
+}
+
 void ProcessScheduler::showScreenList() const {
     std::cout << scheduler->displayScreenList().str();
 }
@@ -89,26 +248,85 @@ std::shared_ptr<Process> ProcessScheduler::fetchProcessByName(const std::string&
     if (scheduler) {
         for (const auto& process : scheduler->processList) {
             // Check if the process already exists
-            if (process->getName() == name) {
+            if (process && process->getName() == name) {
                 return std::make_shared<Process>(*process);
             }
         }
         if (!procExists) {
             // Process does not exist, create a new one
-            int id = static_cast<int>(scheduler->processList.size()) + 1;
-			//size_t requiredMem = memSize > 0 ? memSize : minMemPerProc + rand() % (maxMemPerProc - minMemPerProc + 1);
-			size_t numPages = memSize / this->memPerFrame;
-            std::shared_ptr<Process> p = std::make_shared<Process>(id, name, this->minIns, this->maxIns, memSize, numPages);
-            p->setState(Process::State::READY);
-            // Set startTime to now for new process
-            p->setStartTime(std::chrono::system_clock::now());
-            scheduler->processList.push_back(p); // Add to list of procs
+            std::shared_ptr<Process> p = createProcess(name, memSize);
+            int id = p->getPID();
+            // Add to list of procs, by PID as addProcess stores it
+            if (scheduler->processList.size() <= static_cast<size_t>(id))
+                scheduler->processList.resize(id + 1);
+            scheduler->processList[id] = p;
             return p;
         }
     }
     return nullptr;
 }
 
+std::shared_ptr<Process> ProcessScheduler::createProcess(const std::string& name, size_t memSize) {
+    int id = Scheduler::nextPid();
+	//size_t requiredMem = memSize > 0 ? memSize : minMemPerProc + rand() % (maxMemPerProc - minMemPerProc + 1);
+	size_t numPages = memSize / this->memPerFrame;
+    std::shared_ptr<Process> p = std::make_shared<Process>(id, name, this->minIns, this->maxIns, memSize, numPages);
+    p->setState(Process::State::READY);
+    // Set startTime to now for new process
+    p->setStartTime(std::chrono::system_clock::now());
+    return p;
+}
+
+bool ProcessScheduler::cloneProcess(const std::string& sourceName, const std::string& newName) {
+    if (!scheduler) {
+        std::cerr << "clone warning: No scheduler initialized." << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<Process> source;
+    for (const auto& process : scheduler->processList) {
+        if (process && process->getName() == sourceName) {
+            source = process;
+        }
+    }
+    Scheduler::CloneStatus status = Scheduler::CloneStatus::NOT_RUNNING;
+    std::shared_ptr<Process> child = source ? scheduler->cloneProcess(source, newName, status) : nullptr;
+    switch (status) {
+    case Scheduler::CloneStatus::CLONED:
+        break;
+    case Scheduler::CloneStatus::ON_CORE:
+        // Its counter and memory would be copied mid-instruction
+        std::cout << "Process '" << sourceName << "' did not leave its core. Try again once it is preempted." << std::endl;
+        return false;
+    case Scheduler::CloneStatus::NOT_ADMITTED:
+        std::cout << "Clone of real-time process '" << sourceName << "' not admitted: its deadline cannot be guaranteed "
+            << "alongside the admitted real-time processes." << std::endl;
+        return false;
+    case Scheduler::CloneStatus::NO_MEMORY:
+        std::cout << "Memory of process '" << sourceName << "' could not be copied; clone not created." << std::endl;
+        return false;
+    default:
+        std::cout << "Process '" << sourceName << "' is not running." << std::endl;
+        return false;
+    }
+
+    scheduler->addProcess(child);
+    return true;
+}
+
+bool ProcessScheduler::admitDeadline(const std::shared_ptr<Process>& p, uint64_t deadlineTicks) {
+    if (!scheduler) {
+        std::cerr << "deadline error: No scheduler initialized." << std::endl;
+        return false;
+    }
+    uint64_t deadline = scheduler->getTickCount() + deadlineTicks;
+    if (!scheduler->admitRealtime(p->getPID(), static_cast<size_t>(p->getCmdListSize()), deadline)) {
+        return false;
+    }
+    p->setDeadline(deadline);
+    return true;
+}
+
 bool ProcessScheduler::processExists(const std::string& name) const {
     if (!scheduler) return false;
     for (const auto& proc : scheduler->processList) {
@@ -137,6 +355,44 @@ void ProcessScheduler::loadConfigFromFile(const std::string& filename) {
         else if (key == "quantum-cycles") {
             config >> quantumCycles;
         }
+        else if (key == "mlfq-levels") {
+            config >> mlfqLevels;
+        }
+        else if (key == "mlfq-quanta") {
+            config >> mlfqQuanta;
+        }
+        else if (key == "mlfq-boost") {
+            config >> mlfqBoost;
+        }
+        else if (key == "cfs-latency") {
+            config >> cfsLatency;
+        }
+        else if (key == "cfs-min-granularity") {
+            config >> cfsMinGranularity;
+        }
+        else if (key == "lottery-seed") {
+            config >> lotterySeed;
+        }
+        else if (key == "cpu-period") {
+            config >> cpuPeriod;
+        }
+        else if (key == "group-quota") {
+            std::string group;
+            int64_t quota = 0;
+            config >> group >> quota;
+            groupQuotas.emplace_back(group, quota);
+        }
+        else if (key == "migration-cost") {
+            config >> migrationCost;
+        }
+        else if (key == "pin-cores") {
+            std::string value;
+            config >> value;
+            pinCores = (value == "true" || value == "1");
+        }
+        else if (key == "rt-ins-per-tick") {
+            config >> rtInsPerTick;
+        }
         else if (key == "batch-process-freq") {
             config >> batchProcessFreq;
         }
@@ -161,6 +417,42 @@ void ProcessScheduler::loadConfigFromFile(const std::string& filename) {
         else if (key == "max-mem-per-proc") {
             config >> maxMemPerProc;
         }
+        else if (key == "memory-allocator") {
+            config >> allocatorType;
+        }
+        else if (key == "ws-window") {
+            config >> wsWindow;
+        }
+        else if (key == "thrash-fault-rate") {
+            config >> thrashFaultRate;
+        }
+        else if (key == "swap-readahead") {
+            config >> swapReadahead;
+        }
+        else if (key == "swap-cache-size") {
+            config >> swapCacheSize;
+        }
+        else if (key == "access-trace") {
+            config >> accessTrace;
+        }
+        else if (key == "access-model") {
+            config >> accessModel;
+        }
+        else if (key == "zipf-exponent") {
+            config >> zipfExponent;
+        }
+        else if (key == "phase-length") {
+            config >> phaseLength;
+        }
+        else if (key == "phase-pages") {
+            config >> phasePages;
+        }
+        else if (key == "access-stride") {
+            config >> accessStride;
+        }
+        else if (key == "write-ratio") {
+            config >> writeRatio;
+        }
         else {
             std::string unknownValue;
             config >> unknownValue; // discard
@@ -173,6 +465,20 @@ void ProcessScheduler::loadConfigFromFile(const std::string& filename) {
         << "  num-cpu: " << numCPU << "\n"
         << "  scheduler: " << type << "\n"
         << "  quantum-cycles: " << quantumCycles << "\n"
+        << "  migration-cost: " << migrationCost << "\n"
+        << "  pin-cores: " << (pinCores ? "true" : "false") << "\n"
+        << "  mlfq-levels: " << mlfqLevels << "\n"
+        << "  mlfq-quanta: " << mlfqQuanta << "\n"
+        << "  mlfq-boost: " << mlfqBoost << "\n"
+        << "  cfs-latency: " << cfsLatency << "\n"
+        << "  cfs-min-granularity: " << cfsMinGranularity << "\n"
+        << "  lottery-seed: " << lotterySeed << "\n"
+        << "  rt-ins-per-tick: " << rtInsPerTick << "\n"
+        << "  cpu-period: " << cpuPeriod << "\n";
+    for (const auto& [group, quota] : groupQuotas) {
+        out << "  group-quota: " << group << " " << quota << "\n";
+    }
+    out
         << "  batch-process-freq: " << batchProcessFreq << "\n"
         << "  min-ins: " << minIns << "\n"
         << "  max-ins: " << maxIns << "\n"
@@ -180,7 +486,19 @@ void ProcessScheduler::loadConfigFromFile(const std::string& filename) {
         << "  max-overall-mem: " << maxOverallMem << "\n"
         << "  mem-per-frame: " << memPerFrame << "\n"
         << "  min-mem-per-proc: " << minMemPerProc << "\n"
-        << "  max-mem-per-proc: " << maxMemPerProc << "\n";
+        << "  max-mem-per-proc: " << maxMemPerProc << "\n"
+        << "  memory-allocator: " << allocatorType << "\n"
+        << "  ws-window: " << wsWindow << "\n"
+        << "  thrash-fault-rate: " << thrashFaultRate << "\n"
+        << "  swap-readahead: " << swapReadahead << "\n"
+        << "  swap-cache-size: " << swapCacheSize << "\n"
+        << "  access-trace: " << accessTrace << "\n"
+        << "  access-model: " << accessModel << "\n"
+        << "  zipf-exponent: " << zipfExponent << "\n"
+        << "  phase-length: " << phaseLength << "\n"
+        << "  phase-pages: " << phasePages << "\n"
+        << "  access-stride: " << accessStride << "\n"
+        << "  write-ratio: " << writeRatio << "\n";
 
     std::cout << out.str() << std::endl;
 }
@@ -205,27 +523,11 @@ bool ProcessScheduler::isValidMemorySize(size_t size) const {
 }
 
 void ProcessScheduler::showVMStat() const {
-    if (!scheduler || !demandPagingAllocator) {
-        std::cerr << "vmstat error: No scheduler or demand paging allocator initialized." << std::endl;
+    if (!scheduler || !memoryAllocator) {
+        std::cerr << "vmstat error: No scheduler or memory allocator initialized." << std::endl;
         return;
     }
 
-    // Get memory statistics from the allocator
-    size_t totalMemory = maxOverallMem;
-    size_t usedFrames = demandPagingAllocator->getUsedFrames();
-    size_t totalFrames = demandPagingAllocator->getTotalFrames();
-    size_t freeFrames = demandPagingAllocator->getFreeFrames();
-
-    // Calculate memory in bytes
-    size_t usedMemory = usedFrames * memPerFrame;
-    size_t freeMemory = freeFrames * memPerFrame;
-
-    // Ensure no underflow
-    if (usedMemory > totalMemory) {
-        usedMemory = totalMemory;
-        freeMemory = 0;
-    }
-
     // Count active processes
     int activeProcesses = 0;
     int inactiveProcesses = 0;
@@ -249,26 +551,12 @@ void ProcessScheduler::showVMStat() const {
     uint64_t idleCpuTicks = 0;
 
     // Count active CPU cores
-    int activeCores = 0;
-    const auto& coreBusyFlags = scheduler->getCoreBusy();
-    for (int i = 0; i < numCPU; ++i) {
-        if (i < static_cast<int>(coreBusyFlags.size()) &&
-            coreBusyFlags[i] &&
-            coreBusyFlags[i]->load()) {
-            activeCores++;
-        }
-    }
+    int activeCores = scheduler->getIdleCores().busyCount();
 
     // Estimate active vs idle ticks (simplified calculation)
     activeCpuTicks = scheduler->getTickCount() * activeCores;
     idleCpuTicks = totalCpuTicks - activeCpuTicks;
 
-    // Get paging statistics
-    size_t numPageFaults = demandPagingAllocator->getNumPageFaults();
-    size_t numPagedIn = demandPagingAllocator->getNumPagedIn();
-    size_t numPagedOut = demandPagingAllocator->getNumPagedOut();
-    size_t backingStoreSize = demandPagingAllocator->getBackingStoreSize();
-
     // Display vmstat information
     std::cout << "=== VMSTAT ===" << std::endl;
     std::cout << std::endl;
@@ -276,8 +564,59 @@ void ProcessScheduler::showVMStat() const {
     // Process information
     std::cout << "Active processes: " << activeProcesses << std::endl;
     std::cout << "Inactive processes: " << inactiveProcesses << std::endl;
+    std::cout << "Suspended processes: " << scheduler->getSuspendedCount() << std::endl;
+    size_t finished = 0;
+    double meanTurnaround = scheduler->getMeanTurnaroundMs(finished);
+    std::cout << "Mean turnaround: " << std::fixed << std::setprecision(1) << meanTurnaround
+        << " ms (" << finished << " finished)" << std::endl;
+    std::cout << scheduler->schedulerStats();
+    std::cout << scheduler->cpuGroupStats();
     std::cout << std::endl;
 
+    if (demandPagingAllocator) {
+        showPagingStat();
+    }
+    else if (pagingAllocator) {
+        showFrameStat();
+    }
+    else if (flatMemoryAllocator) {
+        showContiguousStat();
+    }
+
+    // CPU tick information
+    std::cout << "Idle cpu ticks: " << idleCpuTicks << std::endl;
+    std::cout << "Active cpu ticks: " << activeCpuTicks << std::endl;
+    std::cout << "Total cpu ticks: " << totalCpuTicks << std::endl;
+    std::cout << std::endl;
+
+    // Memory visualization
+    /*std::cout << "Memory visualization:" << std::endl;
+    std::cout << memoryAllocator->visualizeMemory() << std::endl;*/
+}
+
+void ProcessScheduler::showPagingStat() const {
+    // Get memory statistics from the allocator
+    size_t totalMemory = maxOverallMem;
+    size_t usedFrames = demandPagingAllocator->getUsedFrames();
+    size_t totalFrames = demandPagingAllocator->getTotalFrames();
+    size_t freeFrames = demandPagingAllocator->getFreeFrames();
+
+    // Calculate memory in bytes
+    size_t usedMemory = usedFrames * memPerFrame;
+    size_t freeMemory = freeFrames * memPerFrame;
+
+    // Ensure no underflow
+    if (usedMemory > totalMemory) {
+        usedMemory = totalMemory;
+        freeMemory = 0;
+    }
+
+    // Get paging statistics
+    size_t numPageFaults = demandPagingAllocator->getNumPageFaults();
+    size_t numPagedIn = demandPagingAllocator->getNumPagedIn();
+    size_t numPagedOut = demandPagingAllocator->getNumPagedOut();
+    size_t backingStoreSize = demandPagingAllocator->getBackingStoreSize();
+
     // Memory information  
     std::cout << "Total memory: " << totalMemory << " bytes" << std::endl;
     std::cout << "Used memory: " << usedMemory << " bytes" << std::endl;
@@ -289,15 +628,83 @@ void ProcessScheduler::showVMStat() const {
     std::cout << "Pages loaded (paged in): " << numPagedIn << std::endl;
     std::cout << "Pages evicted (paged out): " << numPagedOut << std::endl;
     std::cout << "Pages in backing store: " << backingStoreSize << std::endl;
+    std::cout << "Backing store file size: " << demandPagingAllocator->getBackingStoreFileSize() << " bytes" << std::endl;
+    std::cout << "Backing store bytes punched: " << demandPagingAllocator->getBackingStoreBytesPunched() << " bytes" << std::endl;
+    std::cout << "Page faults: " << numPageFaults << std::endl;
+    std::cout << "Zero page mappings: " << demandPagingAllocator->getZeroPageMaps() << std::endl;
+    std::cout << "Copy-on-write faults: " << demandPagingAllocator->getCowFaults() << std::endl;
+    if (accessTrace != "off") {
+        std::cout << "Traced accesses: " << demandPagingAllocator->getTracedAccesses() << " (" << accessTrace << ")" << std::endl;
+    }
+
+    size_t readaheadPages = demandPagingAllocator->getReadaheadPages();
+    size_t readaheadHits = demandPagingAllocator->getReadaheadHits();
+    std::cout << "Readahead pages: " << readaheadPages << ", hits: " << readaheadHits
+        << " (" << std::fixed << std::setprecision(2)
+        << (readaheadPages ? 100.0 * readaheadHits / readaheadPages : 0.0) << "%)" << std::endl;
     std::cout << std::endl;
 
-    // CPU tick information
-    std::cout << "Idle cpu ticks: " << idleCpuTicks << std::endl;
-    std::cout << "Active cpu ticks: " << activeCpuTicks << std::endl;
-    std::cout << "Total cpu ticks: " << totalCpuTicks << std::endl;
+    // Compressed swap cache statistics
+    SwapCacheStats cache = demandPagingAllocator->getSwapCacheStats();
+    std::cout << "Swap cache: " << cache.entries << " pages, " << cache.storedBytes << "/" << cache.budget << " bytes" << std::endl;
+    std::cout << "Compression ratio: " << std::fixed << std::setprecision(2) << cache.compressionRatio << ":1" << std::endl;
+    std::cout << "Swap cache hits: " << cache.hits << std::endl;
+    std::cout << "File I/O avoided: " << (cache.stores - cache.writebacks) << " page writes, "
+        << cache.hits << " page reads" << std::endl;
     std::cout << std::endl;
 
-    // Memory visualization
-    /*std::cout << "Memory visualization:" << std::endl;
-    std::cout << demandPagingAllocator->visualizeMemory() << std::endl;*/
+    // Working-set / thrashing statistics
+    std::cout << "Total working set: " << demandPagingAllocator->getTotalWorkingSet() << "/" << totalFrames << " frames" << std::endl;
+    std::cout << "Fault rate (last window): " << std::fixed << std::setprecision(2) << demandPagingAllocator->getFaultRate() << std::endl;
+    std::cout << "Thrashing: " << (demandPagingAllocator->isThrashing() ? "yes" : "no") << std::endl;
+    std::cout << std::endl;
+}
+
+void ProcessScheduler::showFrameStat() const {
+    // Paging allocator statistics (all pages resident, no backing store)
+    std::cout << "Total memory: " << maxOverallMem << " bytes" << std::endl;
+    std::cout << "Used memory: " << pagingAllocator->getUsedFrames() * memPerFrame << " bytes" << std::endl;
+    std::cout << "Free memory: " << pagingAllocator->getFreeFrames() * memPerFrame << " bytes" << std::endl;
+    std::cout << "Memory frames used: " << pagingAllocator->getUsedFrames() << "/" << pagingAllocator->getTotalFrames() << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Pages loaded (paged in): " << pagingAllocator->getNumPagedIn() << std::endl;
+    std::cout << "Pages released (paged out): " << pagingAllocator->getNumPagedOut() << std::endl;
+    std::cout << std::endl;
+}
+
+void ProcessScheduler::showContiguousStat() const {
+    // Contiguous allocator statistics
+    std::cout << "Allocator: " << FlatMemoryAllocator::policyName(flatMemoryAllocator->getPolicy()) << std::endl;
+    std::cout << "Total memory: " << flatMemoryAllocator->getTotalSize() << " bytes" << std::endl;
+    std::cout << "Used memory: " << flatMemoryAllocator->getAllocatedSize() << " bytes" << std::endl;
+    std::cout << "Free memory: " << flatMemoryAllocator->getFreeSize() << " bytes" << std::endl;
+    std::cout << "Processes in memory: " << flatMemoryAllocator->getNumAllocations() << std::endl;
+    std::cout << std::endl;
+
+    // Fragmentation
+    std::cout << "Free blocks: " << flatMemoryAllocator->getNumFreeBlocks() << std::endl;
+    std::cout << "Largest free block: " << flatMemoryAllocator->getLargestFreeBlock() << " bytes" << std::endl;
+    std::cout << "External fragmentation: " << std::fixed << std::setprecision(2)
+        << flatMemoryAllocator->getExternalFragmentation() * 100 << "%" << std::endl;
+    std::cout << "Internal fragmentation: " << flatMemoryAllocator->getInternalFragmentation() << " bytes" << std::endl;
+    std::cout << std::endl;
+}
+
+void ProcessScheduler::showMemoryFootprint() const {
+    if (demandPagingAllocator) {
+        std::cout << demandPagingAllocator->footprintReport() << std::endl;
+    }
+    else {
+        std::cerr << "memory-footprint warning: No demand paging allocator initialized, skipping page tables." << std::endl;
+    }
+    std::cout << ProcessArena::report() << std::endl;
+}
+
+void ProcessScheduler::showMemoryView(bool changedOnly) const {
+    if (!memoryAllocator) {
+        std::cerr << "memory-view error: No memory allocator initialized." << std::endl;
+        return;
+    }
+    std::cout << memoryAllocator->visualizeMemory(changedOnly) << std::endl;
 }
\ No newline at end of file
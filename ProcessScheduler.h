@@ -3,18 +3,26 @@
 #include <memory>
 #include <string>
 #include <fstream>
+#include <utility>
+#include <vector>
 #include "Process.h"
 
 // Schedulers
 #include "FCFSScheduler.h"
 #include "RRScheduler.h"
+#include "SJFScheduler.h"
+#include "MLFQScheduler.h"
+#include "CFSScheduler.h"
+#include "LotteryScheduler.h"
+#include "StrideScheduler.h"
 
 class ProcessScheduler {
 public:
     static ProcessScheduler& getInstance();
 
     void init();
-    void showProcessList() const;
+    void showProcessList(const std::string& sortColumn = "") const;
+    void showProcessMemory(int pid) const;  // Paging accounting for screen -r
     void showScreenList() const;
     void makeReportUtil() const;
     void start();
@@ -23,6 +31,8 @@ public:
 
 	void addProcess(std::shared_ptr<Process> p);
 	std::shared_ptr<Process> fetchProcessByName(const std::string& name, size_t memSize);
+	std::shared_ptr<Process> createProcess(const std::string& name, size_t memSize);	// not listed or scheduled yet
+	bool cloneProcess(const std::string& sourceName, const std::string& newName);
 
     void setNumCPU(int n) { numCPU = n; }
     void setSchedulerType(const std::string& s) { type = s; }
@@ -41,18 +51,42 @@ public:
     void loadConfigFromFile(const std::string& filename);
 
     void showVMStat() const;
+    void showMemoryFootprint() const;
+    void showMemoryView(bool changedOnly) const;
 
 	bool processExists(const std::string& name) const;
+	// EDF admission of a new process due deadlineTicks from now, on its instruction count;
+	// gives it the deadline when admitted
+	bool admitDeadline(const std::shared_ptr<Process>& p, uint64_t deadlineTicks);
+	uint64_t getTickCount() const { return scheduler ? scheduler->getTickCount() : 0; }
 
 private:
     ProcessScheduler() {};
     std::shared_ptr<Scheduler> scheduler = nullptr;
-    std::shared_ptr<DemandPagingAllocator> demandPagingAllocator;
+    std::shared_ptr<IMemoryAllocator> memoryAllocator;
+    std::shared_ptr<DemandPagingAllocator> demandPagingAllocator;   // set when memory-allocator is demand-paging
+    std::shared_ptr<PagingAllocator> pagingAllocator;               // set when memory-allocator is paging
+    std::shared_ptr<FlatMemoryAllocator> flatMemoryAllocator;       // set for buddy / first-fit / best-fit / next-fit
+
+    void showPagingStat() const;
+    void showFrameStat() const;
+    void showContiguousStat() const;
 
     // Scheduler parameters (default)
     int         numCPU = 4;
     std::string type = "rr";
     int         quantumCycles = 5;
+    int         migrationCost = 1;      // RR: quantum instructions lost when a process moves off a warm core
+    bool        pinCores = false;       // pin each core thread to a host CPU
+    int         mlfqLevels = 3;
+    std::string mlfqQuanta = "auto";    // comma-separated per level, "auto" doubles quantum-cycles
+    int         mlfqBoost = 10;         // CPU ticks between priority boosts, 0 disables
+    int         cfsLatency = 24;        // instructions in which every runnable process runs once
+    int         cfsMinGranularity = 3;  // shortest fair scheduler timeslice, in instructions
+    uint64_t    lotterySeed = 0;        // lottery draws, 0 seeds from std::random_device
+    int         rtInsPerTick = 5;       // instructions per core per CPU tick assumed by EDF admission
+    int         cpuPeriod = 1;          // CPU ticks between group quota refills
+    std::vector<std::pair<std::string, int64_t>> groupQuotas;  // group-quota <group> <instructions per period>
     int         batchProcessFreq = 1;
     int         minIns = 1000;
     int         maxIns = 2000;
@@ -61,4 +95,16 @@ private:
     size_t      memPerFrame = 16;
     size_t      minMemPerProc = 4096;
     size_t      maxMemPerProc = 8192;
+    std::string allocatorType = "demand-paging";
+    size_t      wsWindow = 1000;        // working-set window, in page accesses
+    double      thrashFaultRate = 0.5;  // fault rate that marks memory as thrashing
+    size_t      swapReadahead = 8;      // swapped neighbours read in on a fault, 0 disables
+    size_t      swapCacheSize = 4096;   // compressed swap cache budget in bytes, 0 disables
+    std::string accessTrace = "off";    // file to record page accesses to, "off" disables
+    std::string accessModel = "uniform"; // uniform, sequential, zipf, phased or stride
+    double      zipfExponent = 1.0;
+    size_t      phaseLength = 500;      // accesses before a phased working set moves
+    size_t      phasePages = 0;         // pages per phase, 0 = a quarter of the process
+    size_t      accessStride = 8;       // pages between consecutive stride accesses
+    double      writeRatio = 0.25;      // fraction of page accesses that are writes
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "Process.h"
+
+// Entry of the scheduler's process table: the owning pointer, and beside it the
+// attributes dispatch decisions read (scheduling class, deadline, weight, tickets
+// and CPU group). The table keeps its slots in dense chunks, so a scheduler
+// deciding where a queued process goes reads this entry rather than the Process;
+// the Process itself holds the state a core changes while running it.
+// Copied from the process when it is registered, and fixed from then on, so
+// cores read it without a lock.
+struct ProcessSlot {
+    std::shared_ptr<Process> process;   // owner
+    uint64_t deadline = 0;              // absolute CPU tick, real-time processes only
+    uint32_t tickets = Process::DEFAULT_TICKETS;
+    uint16_t cpuGroup = 0;              // index into Scheduler::cpuGroups
+    int8_t nice = 0;
+    bool realtime = false;
+
+    ProcessSlot() = default;
+    ProcessSlot(std::shared_ptr<Process> owner, uint16_t group)
+        : process(std::move(owner)), deadline(process->getDeadline()), tickets(process->getTickets()),
+        cpuGroup(group), nice(static_cast<int8_t>(process->getNice())), realtime(process->isRealtime()) {
+    }
+};
@@ -1,153 +1,101 @@
 ﻿#include "RRScheduler.h"
-
-void RRScheduler::addProcess(std::shared_ptr<Process> process) {
-    if (!running.load()) {
-        return;  // Removed debug output
-    }
-
-    // Store process in processList for screen -ls functionality
-    if (processList.size() <= static_cast<size_t>(process->getPID()))
-        processList.resize(process->getPID() + 1);
-    processList[process->getPID()] = process;
-
-    // Try to allocate memory using the memory allocator
-    void* memPtr = memoryAllocator.allocate(process);
-
-    if (!memPtr) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        readyQueue.push(process); // memory allocation failed → retry later
-        return;
-    }
-    else {
-        // Mark process as allocated 
-        process->setAllocation(true);
-    }
-
-    std::lock_guard<std::mutex> lock(queueMutex);
-    readyQueue.push(process);
-    cvScheduler.notify_one();
-}
+#include <algorithm>
 
 void RRScheduler::schedulerThread() {
     while (running.load() || !readyQueue.empty()) {
         std::unique_lock<std::mutex> lock(queueMutex);
 
         // Wait until there is a process ready to run or shutdown is requested
-        cvScheduler.wait(lock, [this]() {
-            return !readyQueue.empty() || !running.load();
-            });
+        waitForReadyProcess(lock);
+        balanceMemoryLoad();
 
-        // Assign the next process in the ready queue to an available CPU core
+        // Assign the next process in the ready queue to an available CPU core,
+        // walking the idle cores a word of the idle mask at a time
         static int lastAssignedCore = 0;
-        for (int i = 0; i < numCores && !readyQueue.empty(); ++i) {
-            int core = (lastAssignedCore + i) % numCores;
-            if (!coreBusy[core].get()->load()) { // if the core is not busy
-                std::shared_ptr<Process> proc = readyQueue.front();
+        int start = lastAssignedCore;
+        int offset = 0;
+        for (int core; (!readyQueue.empty() || !realtimeQueue.empty()) && (core = idleCores.nextIdleFrom(start, offset)) >= 0; ++offset) {
+            // Real-time processes first, earliest deadline first
+            ProcessHandle handle;
+            if (!popRealtime(handle)) {
+                handle = readyQueue.front();
                 readyQueue.pop();
+            }
 
-                if (!proc->isAllocated()) {
-                    // Attempt to allocate memory for the process
-                    void* memPtr = memoryAllocator.allocate(proc);
-
-                    if (!memPtr) { // still no memory available
-                        readyQueue.push(proc); // retry later
-                        continue;
-                    }
-                    else {
-                        proc->setAllocation(true);
-                    }
-                }
-
-                {
-                    std::lock_guard<std::mutex> core_lock(coreMutexes[core]);
-                    currentProcess[core] = proc;
-                    coreBusy[core].get()->store(true);
-                }
+            if (!takeForDispatch(handle)) continue;
 
-                cvCores[core].notify_one(); // Notify the core thread to start processing
+            // Back to the core that last ran it if that one is idle
+            int placed = placeOnCore(handle, core);
+            assignCore(placed, handle);
+            if (placed == core) {
                 lastAssignedCore = (core + 1) % numCores; // Round robin core assignment
             }
+            else {
+                --offset; // the rotation's core is still idle
+            }
         }
     }
 }
 
-void RRScheduler::cpuCoreThread(int coreID) {
-    while (running.load() || !readyQueue.empty() || currentProcess[coreID] != nullptr) {
-        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
+int RRScheduler::placeOnCore(ProcessHandle handle, int idleCore) {
+    Affinity& affinity = affinities.get(handle);
 
-        cvCores[coreID].wait(lock, [this, coreID]() {
-            return currentProcess[coreID] != nullptr || !running.load();
-            });
+    int core = idleCore;
+    int quantum = quantumCycles;
+    if (affinity.core >= 0 && idleCores.isIdle(affinity.core)) {
+        core = affinity.core;
+        affineDispatches++;
+    }
+    else if (affinity.core >= 0) {
+        if (coreDispatches[affinity.core] - affinity.dispatch < CACHE_WARM_QUANTA) {
+            // Part of the quantum goes to refilling the cache on the new core
+            quantum = std::max(1, quantumCycles - migrationCost);
+            warmMigrations++;
+        }
+        else {
+            coldMigrations++;
+        }
+    }
 
-        if (currentProcess[coreID] == nullptr) continue;
+    coreQuantum[core] = quantum;
+    affinity.core = core;
+    affinity.dispatch = ++coreDispatches[core];
+    return core;
+}
 
-        std::shared_ptr<Process> proc = currentProcess[coreID];
-        proc->setState(Process::State::RUNNING);
+void RRScheduler::cpuCoreThread(int coreID) {
+    liveCoreThreads.fetch_add(1);
+    while (running.load() || !readyQueue.empty() || currentProcess[coreID].valid()) {
+        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
 
-        if (proc->getStartTime() == std::chrono::system_clock::time_point{}) {
-            proc->setStartTime(std::chrono::system_clock::now());
-        }
+        ProcessHandle handle;
+        Process* proc = waitForProcess(coreID, lock, handle);
+        if (!proc) continue;
+        int quantum = coreQuantum[coreID];
 
         lock.unlock();
 
-        // Execute process for quantum
-        int instructionsExecuted = 0;
-        while (instructionsExecuted < quantumCycles && !proc->isFinished()) {
-            // Simulate page accesses during instruction execution
-            DemandPagingAllocator* demandPagingAlloc = dynamic_cast<DemandPagingAllocator*>(&memoryAllocator);
-            if (demandPagingAlloc && proc->getNumPages() > 0) {
-                size_t pageToAccess = rand() % proc->getNumPages();
-                bool isWrite = (rand() % 4 == 0); // 25% chance of write operation
-                demandPagingAlloc->accessPage(proc->getPID(), pageToAccess, isWrite);
-            }
-
-            proc->executeCurrentCommand(coreID);
-            //proc->addLog(coreID, "Hello world from " + proc->getName());
-            proc->moveToNextLine();
-            instructionsExecuted++;
-
-            if (delayPerExec > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(delayPerExec));
-            }
-        }
+        // Execute process for quantum, simulating page accesses per instruction
+        runOnCore(handle, coreID, quantum);
+        if (!running.load()) break; // exiting, cleanUp has emptied the queues
 
         // Process completion handling
         lock.lock();
         if (proc->isFinished()) {
-            proc->setState(Process::State::TERMINATED);
-            proc->setEndTime(std::chrono::system_clock::now());
-
-            // Deallocate memory for the process
-            memoryAllocator.deallocate(proc);
-            proc->setAllocation(false);
-
-            // Ensure process is properly tracked
-            if (processList.size() <= static_cast<size_t>(proc->getPID())) {
-                processList.resize(proc->getPID() + 1);
-            }
-            processList[proc->getPID()] = proc;
-
-            {
-                std::lock_guard<std::mutex> finished_lock(finishedMutex);
-                finishedProcesses.push_back(*proc);
-            }
-
-            currentProcess[coreID] = nullptr;
-            coreBusy[coreID].get()->store(false);
-            completedProcesses.fetch_add(1);
-
-            // Explicitly notify in case this was the last process
-            cvScheduler.notify_one();
+            retireProcess(handle, coreID);
         }
         else {
-            proc->setState(Process::State::READY);
-            {
-                std::lock_guard<std::mutex> queue_lock(queueMutex);
-                readyQueue.push(proc);
-            }
-            currentProcess[coreID] = nullptr;
-            coreBusy[coreID].get()->store(false);
-            cvScheduler.notify_one();
+            requeueProcess(*proc, coreID, [&]() { makeReady(handle); });
         }
     }
-}
\ No newline at end of file
+    liveCoreThreads.fetch_sub(1);
+}
+
+std::string RRScheduler::schedulerStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    std::ostringstream out;
+    out << "RR placement: " << affineDispatches << " back on their last core, "
+        << warmMigrations + coldMigrations << " migrations (" << warmMigrations << " with a warm cache, "
+        << warmMigrations * migrationCost << " instructions of refill)" << std::endl;
+    return out.str();
+}
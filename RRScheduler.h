@@ -1,20 +1,48 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
 #include "AScheduler.h"
 
+// Round robin with cache affinity. A process goes back to the core that last ran
+// it whenever that core is idle; otherwise it takes the next idle core in the
+// rotation. Moving away while the old core's cache may still hold the process's
+// data (fewer than CACHE_WARM_QUANTA other quanta ran there since) costs
+// migrationCost instructions of the next quantum, the cache refill.
 class RRScheduler : public Scheduler {
 public:
-    RRScheduler(int cores, int quantum, IMemoryAllocator& allocator)
-        : Scheduler(cores, allocator), quantumCycles(quantum) {
+    static constexpr uint64_t CACHE_WARM_QUANTA = 4;
+
+    RRScheduler(int cores, int quantum, int migrationCost, IMemoryAllocator& allocator)
+        : Scheduler(cores, allocator), quantumCycles(quantum), migrationCost(migrationCost),
+        coreQuantum(cores, 0), coreDispatches(cores, 0) {
     }
 
-    void addProcess(std::shared_ptr<Process> process) override;
     void schedulerThread() override;
     void cpuCoreThread(int coreID) override;
+    std::string schedulerStats() const override;
 
     void setQuantumCycles(int q) { quantumCycles = q; }
 
 private:
+    // Where each live process last ran
+    struct Affinity {
+        ProcessHandle handle;
+        int core = -1;
+        uint64_t dispatch = 0;      // coreDispatches[core] when it was placed there
+    };
+
     int quantumCycles;
+    int migrationCost;
     //size_t memPerProc;
-};
\ No newline at end of file
+
+    // Guarded by queueMutex
+    SlotTable<Affinity> affinities;
+    std::vector<int> coreQuantum;           // quantum of the process dispatched to each core
+    std::vector<uint64_t> coreDispatches;   // quanta dispatched to each core so far
+    uint64_t affineDispatches = 0;
+    uint64_t warmMigrations = 0;
+    uint64_t coldMigrations = 0;
+
+    int placeOnCore(ProcessHandle handle, int idleCore);
+};
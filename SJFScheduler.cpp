@@ -0,0 +1,111 @@
+#include "SJFScheduler.h"
+#include <algorithm>
+
+void SJFScheduler::queueJob(ProcessHandle handle, const Process& proc) {
+    jobs.push(handle.index(), JobKey(proc.getRemainingBurstTime(), jobSequence++), handle);
+}
+
+void SJFScheduler::collectArrivals() {
+    while (!readyQueue.empty()) {
+        ProcessHandle handle = readyQueue.front();
+        readyQueue.pop();
+        if (Process* proc = resolve(handle)) {
+            queueJob(handle, *proc);
+        }
+    }
+}
+
+void SJFScheduler::balanceJobs() {
+    if (memoryAllocator.isThrashing() && !jobs.empty()) {
+        // Suspend the longest queued job, the one SJF would run last
+        auto victim = std::max_element(jobs.begin(), jobs.end(),
+            [](const auto& a, const auto& b) { return a.key < b.key; });
+        ProcessHandle handle = victim->value;
+        jobs.erase(victim->id);
+        if (resolve(handle)) {
+            suspendReadyProcess(handle);
+        }
+        return;
+    }
+
+    resumeSuspendedProcesses();
+}
+
+bool SJFScheduler::shouldYield(ProcessHandle handle, const Process& proc) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    collectArrivals();
+    // An idle core will take the waiting job without preempting this one
+    if (hasIdleCore()) {
+        return false;
+    }
+    const ProcessSlot& slot = slotOf(handle);
+    if (!realtimeQueue.empty() && (!slot.realtime || realtimeQueue.top().key.first < slot.deadline)) {
+        return true;
+    }
+    return !slot.realtime && !jobs.empty() && jobs.top().key.first < proc.getRemainingBurstTime();
+}
+
+void SJFScheduler::schedulerThread() {
+    while (running.load() || !readyQueue.empty()) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        // Wake up for arrivals, and for freed cores while jobs are waiting
+        waitForWork(lock, [this]() { return !jobs.empty(); });
+
+        collectArrivals();
+        balanceJobs();
+        collectArrivals();  // resumed processes
+
+        // Give each idle core the earliest deadline, or else the shortest waiting job
+        for (int core = idleCores.nextIdle(0); core >= 0 && (!jobs.empty() || !realtimeQueue.empty()); core = idleCores.nextIdle(core + 1)) {
+            ProcessHandle handle;
+            if (!popRealtime(handle)) {
+                handle = jobs.pop().value;
+            }
+
+            if (takeForDispatch(handle)) {
+                assignCore(core, handle);
+            }
+        }
+    }
+}
+
+void SJFScheduler::cpuCoreThread(int coreID) {
+    liveCoreThreads.fetch_add(1);
+    while (running.load() || currentProcess[coreID].valid()) {
+        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
+
+        ProcessHandle handle;
+        Process* proc = waitForProcess(coreID, lock, handle);
+        if (!proc) continue;
+
+        lock.unlock();
+
+        if (preemptive) {
+            // Keep the core across quantum boundaries until a shorter job or a deadline needs it,
+            // or the group's CPU quota runs out
+            int executed;
+            do {
+                executed = runOnCore(handle, coreID, quantumCycles);
+            } while (running.load() && !proc->isFinished() && executed > 0 && !shouldYield(handle, *proc));
+        }
+        else {
+            runOnCore(handle, coreID, -1);
+        }
+        if (!running.load()) break; // exiting, cleanUp has emptied the queues
+
+        lock.lock();
+        if (proc->isFinished()) {
+            retireProcess(handle, coreID);
+        }
+        else {
+            // Preempted: back into the heap under its new remaining time
+            requeueProcess(*proc, coreID, [&]() {
+                if (!queueRealtime(handle)) {
+                    queueJob(handle, *proc);
+                }
+                });
+        }
+    }
+    liveCoreThreads.fetch_sub(1);
+}
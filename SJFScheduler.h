@@ -0,0 +1,37 @@
+#pragma once
+
+#include <utility>
+#include "AScheduler.h"
+#include "IndexedMinHeap.h"
+
+// Shortest job first on remaining instructions. Non-preemptive (sjf) runs the
+// dispatched process to completion; preemptive (srtf) checks at every quantum
+// boundary and gives the core up once a shorter job is waiting for it.
+class SJFScheduler : public Scheduler {
+public:
+    SJFScheduler(int cores, int quantum, bool preemptive, IMemoryAllocator& allocator)
+        : Scheduler(cores, allocator), quantumCycles(quantum), preemptive(preemptive) {
+    }
+
+    void schedulerThread() override;
+    void cpuCoreThread(int coreID) override;
+
+    void setQuantumCycles(int q) { quantumCycles = q; }
+
+private:
+    // Remaining instructions, then arrival order between equal jobs
+    typedef std::pair<int, uint64_t> JobKey;
+
+    int quantumCycles;
+    bool preemptive;
+
+    // readyQueue takes arrivals as in the other schedulers; the scheduler and the
+    // cores move them in here. Both are guarded by queueMutex.
+    IndexedMinHeap<JobKey, ProcessHandle> jobs;
+    uint64_t jobSequence = 0;
+
+    void queueJob(ProcessHandle handle, const Process& proc);
+    void collectArrivals();
+    void balanceJobs();
+    bool shouldYield(ProcessHandle handle, const Process& proc);
+};
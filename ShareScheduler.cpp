@@ -0,0 +1,182 @@
+#include "ShareScheduler.h"
+#include <algorithm>
+
+ShareScheduler::Share& ShareScheduler::shareOf(ProcessHandle handle) {
+    bool fresh;
+    Share& share = shares.get(handle, fresh);
+    if (fresh) {
+        if (resolve(handle)) {
+            const ProcessSlot& slot = slotOf(handle);
+            share.tickets = std::max<uint64_t>(slot.tickets, 1);
+            share.group = slot.cpuGroup;
+        }
+        if (groups.size() <= static_cast<size_t>(share.group)) {
+            groups.resize(share.group + 1);
+        }
+    }
+    return share;
+}
+
+void ShareScheduler::queueShare(Share& share) {
+    if (!share.runnable) {
+        share.runnable = true;
+        runnableTickets += share.tickets;
+        groups[share.group].runnableTickets += share.tickets;
+    }
+    share.queued = true;
+    queuedCount++;
+    enqueue(share);
+}
+
+bool ShareScheduler::takeShare(ProcessHandle& handle) {
+    if (!dequeue(handle)) {
+        return false;
+    }
+    shares.atSlot(handle.index()).queued = false;
+    queuedCount--;
+    return true;
+}
+
+void ShareScheduler::leaveRunnable(Share& share) {
+    if (share.queued) {
+        remove(share);
+        share.queued = false;
+        queuedCount--;
+    }
+    if (share.runnable) {
+        share.runnable = false;
+        runnableTickets -= share.tickets;
+        groups[share.group].runnableTickets -= share.tickets;
+    }
+}
+
+void ShareScheduler::account(Share& share, int executed) {
+    // Every group with runnable tickets was entitled to its fraction of this quantum
+    if (executed <= 0 || runnableTickets == 0) {
+        return;
+    }
+    for (Group& group : groups) {
+        if (group.runnableTickets > 0) {
+            group.entitled += static_cast<double>(executed) * group.runnableTickets / runnableTickets;
+        }
+    }
+    groups[share.group].executed += executed;
+    charge(share, executed);
+}
+
+void ShareScheduler::collectArrivals() {
+    while (!readyQueue.empty()) {
+        ProcessHandle handle = readyQueue.front();
+        readyQueue.pop();
+        if (resolve(handle)) {
+            queueShare(shareOf(handle));
+        }
+    }
+}
+
+void ShareScheduler::balanceShares() {
+    if (memoryAllocator.isThrashing() && queuedCount > 0) {
+        // Suspend the queued process with the fewest tickets, the smallest claim on the cores
+        Share* victim = nullptr;
+        for (Share& share : shares) {
+            if (share.queued && (!victim || share.tickets < victim->tickets)) {
+                victim = &share;
+            }
+        }
+        ProcessHandle handle = victim->handle;
+        leaveRunnable(*victim);
+        if (resolve(handle)) {
+            suspendReadyProcess(handle);
+        }
+        return;
+    }
+
+    resumeSuspendedProcesses();
+}
+
+void ShareScheduler::schedulerThread() {
+    while (running.load() || !readyQueue.empty()) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        // Wake up for arrivals, and for freed cores while processes are queued
+        waitForWork(lock, [this]() { return queuedCount > 0; });
+
+        collectArrivals();
+        balanceShares();
+        collectArrivals();  // resumed processes
+
+        // Give each idle core the earliest deadline, or else the process the policy picks
+        for (int core = idleCores.nextIdle(0); core >= 0 && (queuedCount > 0 || !realtimeQueue.empty()); core = idleCores.nextIdle(core + 1)) {
+            ProcessHandle handle;
+            if (!popRealtime(handle)) {
+                takeShare(handle);
+            }
+
+            if (takeForDispatch(handle)) {
+                assignCore(core, handle);
+            }
+        }
+    }
+}
+
+void ShareScheduler::cpuCoreThread(int coreID) {
+    liveCoreThreads.fetch_add(1);
+    while (running.load() || currentProcess[coreID].valid()) {
+        std::unique_lock<std::mutex> lock(coreMutexes[coreID]);
+
+        ProcessHandle handle;
+        Process* proc = waitForProcess(coreID, lock, handle);
+        if (!proc) continue;
+
+        lock.unlock();
+
+        int executed = runOnCore(handle, coreID, quantumCycles);
+        if (!running.load()) break; // exiting, cleanUp has emptied the queues
+
+        lock.lock();
+        if (proc->isFinished()) {
+            if (!slotOf(handle).realtime) {
+                std::lock_guard<std::mutex> queue_lock(queueMutex);
+                Share& share = shareOf(handle);
+                account(share, executed);
+                leaveRunnable(share);
+            }
+            retireProcess(handle, coreID);
+        }
+        else {
+            // Quantum used up: charged, then back in the draw
+            requeueProcess(*proc, coreID, [&]() {
+                if (!queueRealtime(handle)) {
+                    Share& share = shareOf(handle);
+                    account(share, executed);
+                    queueShare(share);
+                }
+                });
+        }
+    }
+    liveCoreThreads.fetch_sub(1);
+}
+
+std::string ShareScheduler::schedulerStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    uint64_t executed = 0;
+    for (const Group& group : groups) {
+        executed += group.executed;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << policyName() << " runnable tickets: " << runnableTickets << std::endl;
+    out << policyStats();
+    out << policyName() << " CPU share by group (achieved / entitled by tickets):" << std::endl;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const Group& group = groups[i];
+        double achieved = executed > 0 ? 100.0 * group.executed / executed : 0.0;
+        double target = executed > 0 ? 100.0 * group.entitled / executed : 0.0;
+        out << "  " << std::left << std::setw(12) << cpuGroups[i].name << std::right
+            << std::setw(6) << achieved << "% / " << std::setw(5) << target << "%"
+            << "  (" << group.runnableTickets << " runnable tickets)" << std::endl;
+    }
+    return out.str();
+}
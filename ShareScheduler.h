@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AScheduler.h"
+
+// Proportional-share scheduling. Every process holds tickets and belongs to a
+// group (screen -s --tickets / --group; batch processes hold the default tickets
+// in the batch group), and a
+// group is entitled to its runnable members' tickets over all runnable tickets
+// of the cores. The lottery and stride subclasses only choose which queued
+// process runs next; this class dispatches, runs quanta and keeps the per-group
+// accounting that schedulerStats compares against the entitlement.
+class ShareScheduler : public Scheduler {
+public:
+    ShareScheduler(int cores, int quantum, IMemoryAllocator& allocator)
+        : Scheduler(cores, allocator), quantumCycles(quantum) {
+    }
+
+    void schedulerThread() override;
+    void cpuCoreThread(int coreID) override;
+    std::string schedulerStats() const override;
+
+    void setQuantumCycles(int q) { quantumCycles = q; }
+
+protected:
+    struct Share {
+        ProcessHandle handle;
+        uint64_t tickets = Process::DEFAULT_TICKETS;
+        uint64_t pass = 0;          // stride scheduling only
+        int group = 0;
+        bool runnable = false;      // queued or running, counted in runnableTickets
+        bool queued = false;
+    };
+
+    // Guarded by queueMutex, like everything below
+    virtual void enqueue(Share& share) = 0;
+    virtual bool dequeue(ProcessHandle& handle) = 0;    // false when nothing is queued
+    virtual void remove(const Share& share) = 0;        // a queued share leaving early
+    virtual void charge(Share& /*share*/, int /*executed*/) {}  // after each quantum, before it requeues
+    virtual std::string policyName() const = 0;
+    virtual std::string policyStats() const { return std::string(); }
+
+    SlotTable<Share> shares;
+    uint64_t runnableTickets = 0;
+
+private:
+    // By CPU group index, the same groups that carry CPU quotas
+    struct Group {
+        uint64_t runnableTickets = 0;
+        uint64_t executed = 0;      // instructions run by its members
+        double entitled = 0;        // instructions its tickets were worth while they ran
+    };
+
+    int quantumCycles;
+    std::vector<Group> groups;
+    size_t queuedCount = 0;
+
+    Share& shareOf(ProcessHandle handle);
+    void queueShare(Share& share);
+    bool takeShare(ProcessHandle& handle);
+    void leaveRunnable(Share& share);
+    void account(Share& share, int executed);
+    void collectArrivals();
+    void balanceShares();
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// 32-bit generational handle: low 24 bits are the slot index, high 8 bits the
+// generation of the slot when the handle was issued.
+struct SlotHandle {
+    static constexpr uint32_t INDEX_BITS = 24;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    uint32_t value = UINT32_MAX;
+
+    SlotHandle() = default;
+    SlotHandle(uint32_t index, uint32_t generation) : value((generation << INDEX_BITS) | index) {}
+
+    uint32_t index() const { return value & INDEX_MASK; }
+    uint32_t generation() const { return value >> INDEX_BITS; }
+    bool valid() const { return value != UINT32_MAX; }
+    void reset() { value = UINT32_MAX; }
+
+    bool operator==(const SlotHandle& other) const { return value == other.value; }
+    bool operator!=(const SlotHandle& other) const { return value != other.value; }
+};
+
+// Slot map addressed by SlotHandle. Erasing a slot bumps its generation, so
+// handles to the old occupant stop resolving instead of dangling.
+// Slots live in fixed-size chunks behind a directory allocated up front: inserting
+// never moves existing slots, so get() may run concurrently with insert/erase of
+// other slots. insert/erase themselves must be serialized by the caller.
+template <typename T>
+class SlotMap {
+public:
+    static constexpr uint32_t CHUNK_SLOTS = 1024;
+    static constexpr uint32_t MAX_SLOTS = SlotHandle::INDEX_MASK;   // last index is the null handle's
+    static constexpr uint32_t MAX_CHUNKS = (MAX_SLOTS + CHUNK_SLOTS - 1) / CHUNK_SLOTS;
+
+    SlotMap() : chunks(std::make_unique<std::unique_ptr<Slot[]>[]>(MAX_CHUNKS)) {}
+
+    // Returns an invalid handle when every slot is in use
+    SlotHandle insert(T value) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            // Oldest free slot first, so a generation is reused as late as possible
+            index = freeSlots.front();
+            freeSlots.pop_front();
+        }
+        else if (highWater.load() < MAX_SLOTS) {
+            index = highWater.load();
+            std::unique_ptr<Slot[]>& chunk = chunks[index / CHUNK_SLOTS];
+            if (!chunk) {
+                chunk = std::make_unique<Slot[]>(CHUNK_SLOTS);
+            }
+            highWater.store(index + 1);     // publishes the chunk to get()
+        }
+        else {
+            return SlotHandle();
+        }
+
+        Slot& slot = slotAt(index);
+        slot.value = std::move(value);
+        slot.occupied = true;
+        count++;
+        return SlotHandle(index, slot.generation);
+    }
+
+    bool erase(SlotHandle handle) {
+        Slot* slot = find(handle);
+        if (!slot) {
+            return false;
+        }
+        slot->value = T();
+        slot->occupied = false;
+        slot->generation = (slot->generation + 1) & 0xFF;
+        freeSlots.push_back(handle.index());
+        count--;
+        return true;
+    }
+
+    // Null for an invalid, erased or reused handle
+    T* get(SlotHandle handle) {
+        Slot* slot = find(handle);
+        return slot ? &slot->value : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return const_cast<SlotMap*>(this)->get(handle);
+    }
+
+    void clear() {
+        for (uint32_t index = 0; index < highWater.load(); ++index) {
+            Slot& slot = slotAt(index);
+            if (slot.occupied) {
+                erase(SlotHandle(index, slot.generation));
+            }
+        }
+    }
+
+    size_t size() const { return count; }
+
+private:
+    struct Slot {
+        T value{};
+        uint32_t generation = 0;
+        bool occupied = false;
+    };
+
+    std::unique_ptr<std::unique_ptr<Slot[]>[]> chunks;
+    std::deque<uint32_t> freeSlots;
+    std::atomic<uint32_t> highWater{ 0 };
+    size_t count = 0;
+
+    Slot& slotAt(uint32_t index) { return chunks[index / CHUNK_SLOTS][index % CHUNK_SLOTS]; }
+
+    Slot* find(SlotHandle handle) {
+        if (!handle.valid() || handle.index() >= highWater.load()) {
+            return nullptr;
+        }
+        Slot& slot = slotAt(handle.index());
+        return slot.occupied && slot.generation == handle.generation() ? &slot : nullptr;
+    }
+};
+
+// Side table of per-occupant data kept beside a SlotMap by one of its users, such
+// as a scheduler's state for each process in the process table. Indexed by slot,
+// and T carries the SlotHandle it belongs to: an entry whose handle does not match
+// was left by an earlier occupant of the slot, and is reset to T() on lookup.
+// Not thread-safe: callers serialize access.
+template <typename T>
+class SlotTable {
+public:
+    // Entry of handle's occupant; fresh is set when it was just reset for it
+    T& get(SlotHandle handle, bool& fresh) {
+        if (entries.size() <= handle.index()) {
+            entries.resize(handle.index() + 1);
+        }
+        T& entry = entries[handle.index()];
+        fresh = entry.handle != handle;
+        if (fresh) {
+            entry = T();
+            entry.handle = handle;
+        }
+        return entry;
+    }
+
+    T& get(SlotHandle handle) {
+        bool fresh;
+        return get(handle, fresh);
+    }
+
+    // Entry at a slot index, whoever it belonged to last
+    T& atSlot(uint32_t index) { return entries[index]; }
+
+    // Every entry, including those left by processes that are gone
+    typename std::vector<T>::iterator begin() { return entries.begin(); }
+    typename std::vector<T>::iterator end() { return entries.end(); }
+    typename std::vector<T>::const_iterator begin() const { return entries.begin(); }
+    typename std::vector<T>::const_iterator end() const { return entries.end(); }
+
+private:
+    std::vector<T> entries;
+};
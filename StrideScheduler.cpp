@@ -0,0 +1,33 @@
+#include "StrideScheduler.h"
+#include <algorithm>
+
+void StrideScheduler::enqueue(Share& share) {
+    share.pass = std::max(share.pass, globalPass);
+    passes.push(share.handle.index(), { share.pass, sequence++ }, share.handle);
+}
+
+bool StrideScheduler::dequeue(ProcessHandle& handle) {
+    if (passes.empty()) {
+        return false;
+    }
+    handle = passes.pop().value;
+    return true;
+}
+
+void StrideScheduler::remove(const Share& share) {
+    passes.erase(share.handle.index());
+}
+
+void StrideScheduler::charge(Share& share, int executed) {
+    share.pass += STRIDE1 * executed / share.tickets;
+    globalPass += STRIDE1 * executed / std::max<uint64_t>(runnableTickets, 1);
+}
+
+std::string StrideScheduler::policyStats() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    // In instructions per ticket
+    out << "Stride global pass: " << static_cast<double>(globalPass) / STRIDE1
+        << " (lowest queued " << (passes.empty() ? 0.0 : static_cast<double>(passes.top().key.first) / STRIDE1) << ")" << std::endl;
+    return out.str();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include "ShareScheduler.h"
+#include "IndexedMinHeap.h"
+
+// Stride scheduling, the deterministic counterpart of the lottery. Each process
+// advances a pass value by STRIDE1 / tickets per instruction it executes, and
+// the queued process with the lowest pass runs next, so shares are met within a
+// quantum or so instead of on average. A process that joins or comes back from
+// suspension starts at the global pass and cannot claim CPU time it was absent for.
+class StrideScheduler : public ShareScheduler {
+public:
+    static constexpr uint64_t STRIDE1 = 1 << 20;
+
+    StrideScheduler(int cores, int quantum, IMemoryAllocator& allocator)
+        : ShareScheduler(cores, quantum, allocator) {
+    }
+
+protected:
+    void enqueue(Share& share) override;
+    bool dequeue(ProcessHandle& handle) override;
+    void remove(const Share& share) override;
+    void charge(Share& share, int executed) override;
+    std::string policyName() const override { return "Stride"; }
+    std::string policyStats() const override;
+
+private:
+    // Pass, then queueing order between equal passes
+    IndexedMinHeap<std::pair<uint64_t, uint64_t>, ProcessHandle> passes;
+    uint64_t sequence = 0;
+    uint64_t globalPass = 0;    // advances by STRIDE1 / runnable tickets per instruction
+};
@@ -0,0 +1,131 @@
+#include "SwapCache.h"
+#include <algorithm>
+#include <cstring>
+
+// Control byte c: c < 128 -> c + 1 literal bytes follow,
+//                 c >= 128 -> the next byte repeats (c - 128) + MIN_REPEAT times
+namespace {
+    constexpr size_t MIN_REPEAT = 3;
+    constexpr size_t MAX_LITERAL = 128;
+    constexpr size_t MAX_REPEAT = 127 + MIN_REPEAT;
+}
+
+std::vector<uint8_t> CompressedSwapCache::compress(const char* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    std::vector<uint8_t> out;
+    out.reserve(size / 4 + 2);
+
+    size_t i = 0;
+    size_t literalStart = 0;
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            size_t count = std::min(end - literalStart, MAX_LITERAL);
+            out.push_back(static_cast<uint8_t>(count - 1));
+            out.insert(out.end(), bytes + literalStart, bytes + literalStart + count);
+            literalStart += count;
+        }
+    };
+
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < MAX_REPEAT && bytes[i + run] == bytes[i]) {
+            run++;
+        }
+        if (run >= MIN_REPEAT) {
+            flushLiterals(i);
+            out.push_back(static_cast<uint8_t>(128 + run - MIN_REPEAT));
+            out.push_back(bytes[i]);
+            i += run;
+            literalStart = i;
+        }
+        else {
+            i += run;
+        }
+    }
+    flushLiterals(size);
+    return out;
+}
+
+bool CompressedSwapCache::decompress(const std::vector<uint8_t>& compressed, char* data, size_t size) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < compressed.size()) {
+        uint8_t control = compressed[in++];
+        if (control < 128) {
+            size_t count = size_t{ control } + 1;
+            if (in + count > compressed.size() || out + count > size) return false;
+            std::memcpy(data + out, compressed.data() + in, count);
+            in += count;
+            out += count;
+        }
+        else {
+            size_t count = size_t{ control } - 128 + MIN_REPEAT;
+            if (in >= compressed.size() || out + count > size) return false;
+            std::memset(data + out, compressed[in++], count);
+            out += count;
+        }
+    }
+    return out == size;
+}
+
+bool CompressedSwapCache::store(uint64_t key, const char* data, size_t size) {
+    std::vector<uint8_t> compressed = compress(data, size);
+    if (compressed.size() >= size) {
+        return false; // incompressible, send it straight to the file
+    }
+
+    erase(key);
+    originalBytes += size;
+    compressedBytes += compressed.size();
+    storedBytes += compressed.size();
+
+    lru.push_back(key);
+    entries[key] = Entry{ std::move(compressed), std::prev(lru.end()) };
+    return true;
+}
+
+bool CompressedSwapCache::load(uint64_t key, char* data, size_t size) {
+    auto it = entries.find(key);
+    if (it == entries.end() || !decompress(it->second.data, data, size)) {
+        return false;
+    }
+    erase(key);
+    return true;
+}
+
+void CompressedSwapCache::erase(uint64_t key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return;
+    }
+    storedBytes -= it->second.data.size();
+    lru.erase(it->second.lruPosition);
+    entries.erase(it);
+}
+
+bool CompressedSwapCache::duplicate(uint64_t fromKey, uint64_t toKey) {
+    auto it = entries.find(fromKey);
+    if (it == entries.end() || fromKey == toKey) {
+        return false;
+    }
+
+    erase(toKey);
+    std::vector<uint8_t> copy = it->second.data;
+    storedBytes += copy.size();
+    lru.push_back(toKey);
+    entries[toKey] = Entry{ std::move(copy), std::prev(lru.end()) };
+    return true;
+}
+
+bool CompressedSwapCache::popOldest(uint64_t& key, std::vector<char>& data, size_t size) {
+    if (lru.empty()) {
+        return false;
+    }
+    key = lru.front();
+    data.resize(size);
+    if (!load(key, data.data(), size)) {
+        erase(key); // corrupt entry, drop it rather than retry forever
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Compressed in-memory tier in front of the backing store (zswap-like).
+// Pages are run-length compressed and kept in LRU order within a byte budget;
+// the allocator writes the oldest entries back to the file when it is exceeded.
+class CompressedSwapCache {
+public:
+    explicit CompressedSwapCache(size_t budgetBytes = 0) : budget(budgetBytes) {}
+
+    // Literal runs and repeated-byte runs, one control byte each
+    static std::vector<uint8_t> compress(const char* data, size_t size);
+    static bool decompress(const std::vector<uint8_t>& compressed, char* data, size_t size);
+
+    static uint64_t makeKey(size_t processId, size_t pageNumber) {
+        return (static_cast<uint64_t>(processId) << 32) | static_cast<uint32_t>(pageNumber);
+    }
+    static size_t keyProcess(uint64_t key) { return static_cast<size_t>(key >> 32); }
+    static size_t keyPage(uint64_t key) { return static_cast<size_t>(key & UINT32_MAX); }
+
+    void setBudget(size_t bytes) { budget = bytes; }
+    bool enabled() const { return budget > 0; }
+    bool overBudget() const { return storedBytes > budget; }
+
+    // Fails if the page does not compress to less than its own size
+    bool store(uint64_t key, const char* data, size_t size);
+    // Decompresses and removes the entry
+    bool load(uint64_t key, char* data, size_t size);
+    void erase(uint64_t key);
+    // Stores a copy of an existing entry under another key
+    bool duplicate(uint64_t fromKey, uint64_t toKey);
+    // Removes the least recently stored entry, returning it decompressed
+    bool popOldest(uint64_t& key, std::vector<char>& data, size_t size);
+
+    size_t getEntries() const { return entries.size(); }
+    size_t getStoredBytes() const { return storedBytes; }
+    size_t getBudget() const { return budget; }
+    size_t getOriginalBytes() const { return originalBytes; }     // cumulative, for the ratio
+    size_t getCompressedBytes() const { return compressedBytes; }
+
+private:
+    struct Entry {
+        std::vector<uint8_t> data;
+        std::list<uint64_t>::iterator lruPosition;
+    };
+
+    size_t budget;
+    size_t storedBytes = 0;
+    size_t originalBytes = 0;
+    size_t compressedBytes = 0;
+    std::unordered_map<uint64_t, Entry> entries;
+    std::list<uint64_t> lru;    // front = oldest
+};
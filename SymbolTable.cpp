@@ -1,8 +1,9 @@
 #include "SymbolTable.h"
 
-// private constructor
-SymbolTable::SymbolTable() {
-	table = std::unordered_map<uintptr_t, Symbol>();
+SymbolTable::SymbolTable(std::pmr::memory_resource* resource) : table(resource) {
+}
+
+SymbolTable::SymbolTable(const SymbolTable& other, std::pmr::memory_resource* resource) : table(other.table, resource) {
 }
 
 bool SymbolTable::insert(uintptr_t address, const std::string& name, uint16_t value) {
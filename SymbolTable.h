@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <memory_resource>
 #include <iostream>
 
 class SymbolTable {
@@ -12,10 +13,12 @@ struct Symbol {
 };
 
 private:
-	std::unordered_map<uintptr_t, Symbol> table;
+	std::pmr::unordered_map<uintptr_t, Symbol> table;
 
 public:
-	SymbolTable();
+	// Nodes come from resource, normally the owning process's arena
+	explicit SymbolTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	SymbolTable(const SymbolTable& other, std::pmr::memory_resource* resource);
 
 	bool insert(uintptr_t address, const std::string& name, uint16_t value);
 	bool update(uintptr_t address, uint16_t value);